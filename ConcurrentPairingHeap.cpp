@@ -0,0 +1,72 @@
+//============================================================================
+// Name        : ConcurrentPairingHeap.cpp
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : Test program for ConcurrentPairingHeap.h
+//============================================================================
+
+#include "ConcurrentPairingHeap.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <ctime>
+using namespace std;
+
+const int producers = 4, mn = 20000, rounds = 3;
+
+/**
+ * producers insert every id once per round, each waiting until the consumer has taken it out again,
+ * while the consumer deletes the minima and removes random elements.
+ * Every id must come out exactly once per round, with the key it went in with.
+ */
+template<typename Q>
+bool stress() {
+	Q q(mn);
+	vector<thread> ts;
+	for (int k = 0; k < producers; ++k)
+		ts.push_back(thread([&q, k]() {
+			for (int r = 0; r < rounds; ++r)
+				for (int id = k; id < mn; id += producers) {
+					while (!q.try_insert(id, id ^ 1234))
+						this_thread::yield();
+					// the id is in use until the consumer takes it.
+					try {
+						q.insert(id, 0);
+					} catch (exception &) {
+					}
+				}
+		}));
+	vector<int> seen(mn);
+	bool ok = 1;
+	long long out = 0;
+	typename Q::Element e;
+	while (out < (long long) rounds * mn) {
+		if (q.try_delete_min(e)) {
+			ok = ok && e.key == (e.id ^ 1234) && ++seen[e.id] <= rounds;
+			++out;
+		}
+		int id = rand() % mn;
+		try {
+			q.decrease_key(id, -1);
+			e = q.remove(id);
+			ok = ok && e.id == id && e.key == -1 && ++seen[id] <= rounds;
+			++out;
+		} catch (exception &) {
+		}
+	}
+	for (size_t i = 0; i < ts.size(); ++i)
+		ts[i].join();
+	for (int i = 0; i < mn; ++i)
+		ok = ok && seen[i] == rounds && !q.contains(i);
+	return ok && q.size() == 0 && !q.try_delete_min(e);
+}
+
+int main() {
+	srand(time(0));
+	cout << "two pass: " << stress<ConcurrentPairingHeap<int> >() << endl;
+	cout << "auxiliary, pool: "
+			<< stress<ConcurrentPairingHeap<int, less<int>, PH_PoolAlloc, PH_PointerLayout, PH_AuxTwoPass> >() << endl;
+	cout << "index layout: " << stress<ConcurrentPairingHeap<int, less<int>, PH_NewAlloc, PH_IndexLayout> >() << endl;
+	return 0;
+}
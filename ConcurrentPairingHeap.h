@@ -0,0 +1,261 @@
+//============================================================================
+// Name        : ConcurrentPairingHeap.h
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : pairing heaps with concurrent producers and a single consumer
+//============================================================================
+
+#ifndef CONCURRENTPAIRINGHEAP_H_
+#define CONCURRENTPAIRINGHEAP_H_
+
+#include "PairingHeap.h"
+#include <atomic>
+
+/**
+ * The class of pairing heaps with many producers and a single consumer.
+ * insert, emplace, try_insert, contains and size may be called from any number of threads at the same time.
+ * All other methods must be called from one thread at a time, the consumer.
+ *
+ * Algo:
+ * 		An insert claims the id in a table of atomic flags, which keeps the id's unique,
+ * 		and pushes the new element onto a lock-free (Treiber) stack of staged elements.
+ * 		Before each of its operations, the consumer takes the whole stack with a single atomic exchange,
+ * 		and inserts the staged elements into a @PairingHeap that no other thread touches.
+ * 		The stack is never popped one element at a time, so there is no ABA problem.
+ * An element is visible to the consumer once its insert has returned.
+ * The id of a deleted element may be reused as soon as delete_min (or remove) has returned it.
+ *
+ * Template parameters:
+ * 		the same as @PairingHeap. The auxiliary variants (e.g. PH_AuxTwoPass) suit the bursts of staged inserts well.
+ * 		Since the id table is fixed, so is the maximal size of the heap.
+ *
+ * Producer methods:
+ *		void insert(int id, const T& key), void insert(int id, T&& key):
+ *			try to insert an element with the given id and key.
+ *			Throws an exception if the id is invalid or there's already an element with that id.
+ *		void emplace(int id, Args&&... args):
+ *			like insert, but the key is constructed from args.
+ *		bool try_insert(int id, const T& key), bool try_insert(int id, T&& key):
+ *			like insert, but returns false instead of throwing an exception.
+ *		bool contains(int id):
+ *			determines whether there's an element with the given id, inserted and not deleted yet.
+ *			This won't throw any exceptions.
+ *		size_t size():
+ *			returns the number of elements. It's only exact while no insert is running.
+ *		size_t max_size():
+ *			returns the maximal size.
+ *
+ * Consumer methods:
+ * 		find_min, delete_min, try_delete_min, remove, get_key, decrease_key, increase_key, update_key, stats:
+ * 			the same as those of @PairingHeap, on all the elements whose insert has returned.
+ */
+template<typename T, typename Comparator = std::less<T>,
+		template<typename > class NodeAlloc = PH_NewAlloc,
+		typename Layout = PH_PointerLayout, typename Variant = PH_TwoPass,
+		typename Stats = PH_NoStats>
+class ConcurrentPairingHeap {
+public:
+	typedef PairingHeap<T, Comparator, NodeAlloc, Layout, Variant, Stats> Heap;
+	typedef typename Heap::Element Element;
+private:
+	/**
+	 * An element waiting in the stack for the consumer.
+	 */
+	struct Staged {
+		Staged *next;
+		int id;
+		T key;
+		template<typename ... Args>
+		Staged(int id, Args&&... args) :
+				next(0), id(id), key(std::forward<Args>(args)...) {
+		}
+	};
+
+	// the maximal size. Valid id's are in [0, maxsz).
+	int maxsz;
+	// used[id] is set while an element with this id is staged or in the heap.
+	std::atomic<bool> *used;
+	// the number of elements staged or in the heap.
+	std::atomic<int> sz;
+	// the top of the stack of staged elements.
+	std::atomic<Staged *> staged;
+	// the elements taken from the stack. Only the consumer touches it.
+	Heap heap;
+
+	// the possible exceptions of the producers. (initialized below out of the class)
+	static const PH_Exception PH_EX_BAD_ID, PH_EX_ALREADY_EXISTS;
+
+	// claims id for a new element. False if it's invalid or used.
+	bool claim(int id) {
+		bool expected = false;
+		return id >= 0 && id < maxsz
+				&& used[id].compare_exchange_strong(expected, true,
+						std::memory_order_acquire);
+	}
+	// gives id back after its element has left the heap.
+	void release(int id) {
+		used[id].store(false, std::memory_order_release);
+		sz.fetch_sub(1, std::memory_order_relaxed);
+	}
+	// pushes the chain first, ..., last onto the stack.
+	void push(Staged *first, Staged *last) {
+		last->next = staged.load(std::memory_order_relaxed);
+		while (!staged.compare_exchange_weak(last->next, first,
+				std::memory_order_release, std::memory_order_relaxed))
+			;
+	}
+	// stages a new element with the claimed id.
+	template<typename ... Args>
+	void stage(int id, Args&&... args) {
+		Staged *s;
+		try {
+			s = new Staged(id, std::forward<Args>(args)...);
+		} catch (...) {
+			used[id].store(false, std::memory_order_release);
+			throw;
+		}
+		// counted before it's visible, so that the consumer never makes the count negative.
+		sz.fetch_add(1, std::memory_order_relaxed);
+		push(s, s);
+	}
+	// moves all staged elements into the heap. Only the consumer calls this.
+	void drain() {
+		Staged *s = staged.exchange(0, std::memory_order_acquire);
+		while (s) {
+			try {
+				heap.insert_unchecked(s->id, std::move(s->key));
+			} catch (...) {
+				// put the rest back for the next time.
+				Staged *last = s;
+				while (last->next)
+					last = last->next;
+				push(s, last);
+				throw;
+			}
+			Staged *next = s->next;
+			delete s;
+			s = next;
+		}
+	}
+	// deletes the chain starting at s.
+	static void dispose(Staged *s) {
+		while (s) {
+			Staged *next = s->next;
+			delete s;
+			s = next;
+		}
+	}
+
+	ConcurrentPairingHeap(const ConcurrentPairingHeap &) = delete;
+	ConcurrentPairingHeap &operator=(const ConcurrentPairingHeap &) = delete;
+public:
+	ConcurrentPairingHeap(int max_size) :
+			maxsz(max_size), used(new std::atomic<bool>[max_size]), sz(0), staged(
+					0), heap(max_size) {
+		for (int i = 0; i < max_size; ++i)
+			used[i].store(false, std::memory_order_relaxed);
+	}
+	~ConcurrentPairingHeap() {
+		dispose(staged.load(std::memory_order_acquire));
+		delete[] used;
+	}
+
+	/**
+	 * The producer methods. They may be called from any thread.
+	 */
+	void insert(int id, const T& key) {
+		emplace(id, key);
+	}
+	void insert(int id, T&& key) {
+		emplace(id, std::move(key));
+	}
+	template<typename ... Args>
+	void emplace(int id, Args&&... args) {
+		if (!claim(id))
+			throw id < 0 || id >= maxsz ? PH_EX_BAD_ID : PH_EX_ALREADY_EXISTS;
+		stage(id, std::forward<Args>(args)...);
+	}
+	bool try_insert(int id, const T& key) {
+		if (!claim(id))
+			return false;
+		stage(id, key);
+		return true;
+	}
+	bool try_insert(int id, T&& key) {
+		if (!claim(id))
+			return false;
+		stage(id, std::move(key));
+		return true;
+	}
+	bool contains(int id) const {
+		return id >= 0 && id < maxsz && used[id].load(std::memory_order_acquire);
+	}
+	size_t size() const {
+		return sz.load(std::memory_order_relaxed);
+	}
+	size_t max_size() const {
+		return maxsz;
+	}
+
+	/**
+	 * The consumer methods. Only one thread at a time may call them.
+	 */
+	const Element &find_min() {
+		drain();
+		return heap.find_min();
+	}
+	Element delete_min() {
+		drain();
+		Element r(heap.delete_min());
+		release(r.id);
+		return r;
+	}
+	bool try_delete_min(Element &min) {
+		drain();
+		if (!heap.try_delete_min(min))
+			return false;
+		release(min.id);
+		return true;
+	}
+	Element remove(int id) {
+		drain();
+		Element r(heap.remove(id));
+		release(id);
+		return r;
+	}
+	const T &get_key(int id) {
+		drain();
+		return heap.get_key(id);
+	}
+	template<typename K>
+	void decrease_key(int id, K &&newkey) {
+		drain();
+		heap.decrease_key(id, std::forward<K>(newkey));
+	}
+	template<typename K>
+	void increase_key(int id, K &&newkey) {
+		drain();
+		heap.increase_key(id, std::forward<K>(newkey));
+	}
+	template<typename K>
+	void update_key(int id, K &&newkey) {
+		drain();
+		heap.update_key(id, std::forward<K>(newkey));
+	}
+	const Stats &stats() const {
+		return heap.stats();
+	}
+};
+
+/**
+ * The following are possible exceptions.
+ */
+template<typename T, typename Comparator, template<typename > class NodeAlloc,
+		typename Layout, typename Variant, typename Stats>
+const PH_Exception ConcurrentPairingHeap<T, Comparator, NodeAlloc, Layout, Variant, Stats>::PH_EX_ALREADY_EXISTS(
+		"An element with the same ID already exists.");
+template<typename T, typename Comparator, template<typename > class NodeAlloc,
+		typename Layout, typename Variant, typename Stats>
+const PH_Exception ConcurrentPairingHeap<T, Comparator, NodeAlloc, Layout, Variant, Stats>::PH_EX_BAD_ID("ID out of range!");
+
+#endif /* CONCURRENTPAIRINGHEAP_H_ */
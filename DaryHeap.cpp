@@ -0,0 +1,101 @@
+//============================================================================
+// Name        : DaryHeap.cpp
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : Test program for DaryHeap.h
+//============================================================================
+
+#include "DaryHeap.h"
+#include <iostream>
+#include <set>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+using namespace std;
+
+const int mn = 1000;
+
+template<typename T> T make_key(int v);
+template<> int make_key<int>(int v) {
+	return v;
+}
+template<> string make_key<string>(int v) {
+	char s[16];
+	sprintf(s, "%08d", v + 50000000);
+	return s;
+}
+
+// the first of the D keys no other one is less than, as PH_DaryMin has to find it.
+template<int D>
+bool min_of_d() {
+	int keys[D];
+	for (int round = 0; round < 100000; ++round) {
+		for (int j = 0; j < D; ++j)
+			keys[j] = rand() % 8 - 4 + (rand() % 2 ? 0 : INT_MIN + 4);
+		int best = 0;
+		for (int j = 1; j < D; ++j)
+			if (keys[j] < keys[best])
+				best = j;
+		if (PH_DaryMin<int, less<int>, D>::simd
+				&& PH_DaryMin<int, less<int>, D>::index(keys, less<int>())
+						!= best)
+			return 0;
+	}
+	return 1;
+}
+
+// erases the pair of id from ref.
+void erase_id(set<pair<int, int> > &ref, int id) {
+	for (set<pair<int, int> >::iterator it = ref.begin(); it != ref.end(); ++it)
+		if (it->second == id) {
+			ref.erase(it);
+			return;
+		}
+}
+
+// random operations against a std::set of (key, id).
+template<typename T, typename Comparator, int D>
+bool model(int ops) {
+	DaryHeap<T, Comparator, D> pq(mn);
+	set<pair<int, int> > ref;
+	int sign = Comparator()(make_key<T>(0), make_key<T>(1)) ? 1 : -1;
+	for (int i = 0; i < ops; ++i) {
+		int id = rand() % mn, op = rand() % 7, k = rand() % 100000;
+		if (op < 2) {
+			if (pq.try_insert(id, make_key<T>(k)))
+				ref.insert(make_pair(sign * k, id));
+		} else if (op == 2 && !ref.empty()) {
+			typename DaryHeap<T, Comparator, D>::Element e = pq.delete_min();
+			if (make_key<T>(sign * ref.begin()->first) != e.key)
+				return 0;
+			ref.erase(make_pair(ref.begin()->first, e.id));
+		} else if (op == 3 && pq.contains(id)) {
+			erase_id(ref, id);
+			pq.update_key(id, make_key<T>(k));
+			ref.insert(make_pair(sign * k, id));
+		} else if (op == 4 && pq.contains(id)) {
+			pq.remove(id);
+			erase_id(ref, id);
+		} else if (!ref.empty()
+				&& pq.find_min().key != make_key<T>(sign * ref.begin()->first))
+			return 0;
+		if (pq.size() != ref.size())
+			return 0;
+	}
+	return 1;
+}
+
+int main() {
+	srand(time(0));
+	cout << "min of 4: " << min_of_d<4>() << endl;
+	cout << "min of 8: " << min_of_d<8>() << endl;
+	cout << "2-ary: " << model<int, less<int>, 2>(200000) << endl;
+	cout << "3-ary: " << model<int, less<int>, 3>(200000) << endl;
+	cout << "4-ary: " << model<int, less<int>, 4>(200000) << endl;
+	cout << "8-ary: " << model<int, less<int>, 8>(200000) << endl;
+	cout << "8-ary greater: " << model<int, greater<int>, 8>(200000) << endl;
+	cout << "4-ary string: " << model<string, less<string>, 4>(200000) << endl;
+	return 0;
+}
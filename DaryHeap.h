@@ -0,0 +1,411 @@
+//============================================================================
+// Name        : DaryHeap.h
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : addressable d-ary heaps with the interface of PairingHeap
+//============================================================================
+
+#ifndef DARYHEAP_H_
+#define DARYHEAP_H_
+
+#include "PairingHeap.h"
+#include <vector>
+#if defined(__SSE4_1__) && defined(__GNUC__)
+#include <smmintrin.h>
+#define PH_DARY_SSE 1
+#endif
+
+/**
+ * Finds the first of D adjacent keys which no other one is less than, with vector instructions.
+ * simd is false if there's no such version for the keys, which are then scanned one by one.
+ */
+template<typename T, typename Comparator, int D>
+struct PH_DaryMin {
+	static const bool simd = false;
+	static int index(const T *, const Comparator &) {
+		return 0;
+	}
+};
+
+#ifdef PH_DARY_SSE
+/**
+ * The minimum of 4 or 8 int's with SSE4.1: the minimum is spread over all lanes with pminsd,
+ * and the first lane equal to it is found with a movemask.
+ */
+template<>
+struct PH_DaryMin<int, std::less<int>, 4> {
+	static const bool simd = true;
+	static int index(const int *keys, const std::less<int> &) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys));
+		__m128i m = _mm_min_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+		m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+		return __builtin_ctz(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, m))));
+	}
+};
+template<>
+struct PH_DaryMin<int, std::less<int>, 8> {
+	static const bool simd = true;
+	static int index(const int *keys, const std::less<int> &) {
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + 4));
+		__m128i m = _mm_min_epi32(a, b);
+		m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+		m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+		int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, m)))
+				| _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(b, m))) << 4;
+		return __builtin_ctz(mask);
+	}
+};
+#endif
+
+/**
+ * The class of addressable d-ary implicit heaps.
+ * It has the same interface as @PairingHeap, with the same id's and exceptions,
+ * so that the two can be swapped without touching the call sites.
+ * For small keys such as int's or float's, it's usually faster than a pairing heap,
+ * since it has no links to chase and the children of a node are adjacent.
+ *
+ * Algo:
+ * 		The heap is a complete D-ary tree in an array, with the root at index 0
+ * 		and the children of node i at D*i+1, ..., D*i+D.
+ * 		The keys and the id's are kept in separate arrays, so that the D keys of the children
+ * 		are contiguous. For int keys with std::less and D = 4 or 8, built with SSE4.1 (e.g. -msse4.1 or -march=native),
+ * 		sift_down finds their minimum with a vector min reduction (PH_DaryMin). Otherwise it scans them one by one.
+ * 		pos[id] is the index of the element with this id, or -1.
+ *
+ * Template parameters:
+ * 		typename T:
+ * 			the type of the keys.
+ * 		typename Comparator:
+ * 			the same as in @PairingHeap.
+ * 		int D:
+ * 			the degree of the tree. 4 or 8 are good choices for small keys.
+ *
+ * Public methods:
+ * 		all methods of @PairingHeap except meld, stats, peek_k, extract_k and the *_unchecked ones.
+ * 		find_min returns a copy of the minimum instead of a reference.
+ * Time:
+ * 		Insert and decrease_key take O(log_D n) time, delete_min, remove and increase_key O(D log_D n) time.
+ * 		Find_min, get_key and contains take constant time.
+ */
+template<typename T, typename Comparator = std::less<T>, int D = 4>
+class DaryHeap {
+public:
+	/**
+	 * The representation of an element: a pair (id, key).
+	 */
+	struct Element {
+		int id;
+		T key;
+		Element() :
+				id(-1), key() {
+		}
+		template<typename ... Args>
+		Element(int id, Args&&... args) :
+				id(id), key(std::forward<Args>(args)...) {
+		}
+	};
+private:
+	// the maximal size. Valid id's are in [0, maxsz).
+	int maxsz;
+	Comparator less;
+	// the keys and the id's in heap order.
+	std::vector<T> keys;
+	std::vector<int> ids;
+	// the map from the id's to the indices. It grows on demand if no maximal size is given.
+	std::vector<int> pos;
+
+	// the possible exceptions. (initialized below out of the class)
+	static const PH_Exception PH_EX_EMPTY, PH_EX_BAD_ID, PH_EX_ALREADY_EXISTS,
+			PH_EX_NO_SUCH_ELEMENT;
+
+	// ensures id is valid and there's NO element with this id.
+	void ensure_not_existing(int id) const {
+		if (id < 0 || id >= maxsz)
+			throw PH_EX_BAD_ID;
+		if (contains(id))
+			throw PH_EX_ALREADY_EXISTS;
+	}
+	// ensures id is valid and there's ONE element with this id.
+	void ensure_existing(int id) const {
+		if (id < 0 || id >= maxsz)
+			throw PH_EX_BAD_ID;
+		if (!contains(id))
+			throw PH_EX_NO_SUCH_ELEMENT;
+	}
+	// ensures the heap is non-empty
+	void ensure_nonempty() const {
+		if (keys.empty())
+			throw PH_EX_EMPTY;
+	}
+	// makes pos cover id.
+	void cover(int id) {
+		if (size_t(id) >= pos.size())
+			pos.resize(std::max(size_t(id) + 1, 2 * pos.size()), -1);
+	}
+	// puts the element (id, key) at index i.
+	void place(size_t i, int id, T &&key) {
+		keys[i] = std::move(key);
+		ids[i] = id;
+		pos[id] = int(i);
+	}
+	// moves the element at index i up to its place.
+	void sift_up(size_t i) {
+		T key(std::move(keys[i]));
+		int id = ids[i];
+		while (i > 0) {
+			size_t p = (i - 1) / D;
+			if (!less(key, keys[p]))
+				break;
+			place(i, ids[p], std::move(keys[p]));
+			i = p;
+		}
+		place(i, id, std::move(key));
+	}
+	// moves the element at index i down to its place.
+	void sift_down(size_t i) {
+		size_t n = keys.size();
+		T key(std::move(keys[i]));
+		int id = ids[i];
+		for (;;) {
+			size_t c = D * i + 1;
+			if (c >= n)
+				break;
+			size_t end = std::min(c + D, n), best = c;
+			if (PH_DaryMin<T, Comparator, D>::simd && end - c == size_t(D))
+				best += PH_DaryMin<T, Comparator, D>::index(&keys[c], less);
+			else
+				for (size_t j = c + 1; j < end; ++j)
+					best = less(keys[j], keys[best]) ? j : best;
+			if (!less(keys[best], key))
+				break;
+			place(i, ids[best], std::move(keys[best]));
+			i = best;
+		}
+		place(i, id, std::move(key));
+	}
+	// removes the element at index i and returns it.
+	Element take(size_t i) {
+		Element r(ids[i], std::move(keys[i]));
+		pos[r.id] = -1;
+		size_t last = keys.size() - 1;
+		if (i < last) {
+			place(i, ids[last], std::move(keys[last]));
+			keys.pop_back();
+			ids.pop_back();
+			// the last element might be smaller or larger than the removed one.
+			if (i > 0 && less(keys[i], keys[(i - 1) / D]))
+				sift_up(i);
+			else
+				sift_down(i);
+		} else {
+			keys.pop_back();
+			ids.pop_back();
+		}
+		return r;
+	}
+	// appends a new element without restoring the heap property.
+	template<typename ... Args>
+	void append(int id, Args&&... args) {
+		cover(id);
+		keys.emplace_back(std::forward<Args>(args)...);
+		try {
+			ids.push_back(id);
+		} catch (...) {
+			keys.pop_back();
+			throw;
+		}
+		pos[id] = int(keys.size() - 1);
+	}
+public:
+	DaryHeap() :
+			maxsz(INT_MAX) {
+	}
+	DaryHeap(int max_size) :
+			maxsz(max_size), pos(max_size, -1) {
+	}
+	/**
+	 * removes all elements, keeping the allocated space for reuse.
+	 */
+	void clear() {
+		for (size_t i = 0; i < ids.size(); ++i)
+			pos[ids[i]] = -1;
+		keys.clear();
+		ids.clear();
+	}
+	size_t size() const {
+		return keys.size();
+	}
+	size_t max_size() const {
+		return maxsz;
+	}
+	bool contains(int id) const {
+		return id >= 0 && size_t(id) < pos.size() && pos[id] >= 0;
+	}
+	/**
+	 * returns a copy of the current minimal element in the priority queue.
+	 * The key and the id are in separate arrays, so there's no element to refer to.
+	 * Throws an exception if the pq is empty.
+	 */
+	Element find_min() const {
+		ensure_nonempty();
+		return Element(ids[0], keys[0]);
+	}
+	/**
+	 * returns the current key of the element with the given id.
+	 * Throws an exception if the id is invalid or there's no element with that id.
+	 */
+	const T &get_key(int id) const {
+		ensure_existing(id);
+		return keys[pos[id]];
+	}
+	void insert(int id, const T& key) {
+		emplace(id, key);
+	}
+	void insert(int id, T&& key) {
+		emplace(id, std::move(key));
+	}
+	template<typename ... Args>
+	void emplace(int id, Args&&... args) {
+		ensure_not_existing(id);
+		append(id, std::forward<Args>(args)...);
+		sift_up(keys.size() - 1);
+	}
+	/**
+	 * inserts all elements in the range [first, last) of (id, key) pairs.
+	 * Throws an exception if some id is invalid or used twice, and then no element is inserted.
+	 * Algo:
+	 * 		append them all. Into an empty heap, build it bottom-up in O(k) time; otherwise sift them up.
+	 */
+	template<typename It>
+	void insert_bulk(It first, It last) {
+		for (It it = first; it != last; ++it)
+			ensure_not_existing(it->first);
+		size_t n = keys.size();
+		try {
+			for (It it = first; it != last; ++it) {
+				if (contains(it->first))
+					throw PH_EX_ALREADY_EXISTS;
+				append(it->first, it->second);
+			}
+		} catch (...) {
+			while (keys.size() > n) {
+				pos[ids.back()] = -1;
+				keys.pop_back();
+				ids.pop_back();
+			}
+			throw;
+		}
+		if (n == 0) {
+			if (keys.size() > 1)
+				for (size_t i = (keys.size() - 2) / D + 1; i-- > 0;)
+					sift_down(i);
+		} else
+			for (size_t i = n; i < keys.size(); ++i)
+				sift_up(i);
+	}
+	Element delete_min() {
+		ensure_nonempty();
+		return take(0);
+	}
+	/**
+	 * removes all elements and writes them to out in sorted order.
+	 */
+	template<typename OutIt>
+	OutIt drain_sorted(OutIt out) {
+		while (!keys.empty()) {
+			*out = take(0);
+			++out;
+		}
+		return out;
+	}
+	Element remove(int id) {
+		ensure_existing(id);
+		return take(pos[id]);
+	}
+	/**
+	 * try to decrease the key of the element with the given id.
+	 * It does nothing if newkey is larger than the current key of the element.
+	 */
+	void decrease_key(int id, const T& newkey) {
+		ensure_existing(id);
+		size_t i = pos[id];
+		if (!less(keys[i], newkey)) {
+			keys[i] = newkey;
+			sift_up(i);
+		}
+	}
+	template<typename It>
+	void decrease_key_batch(It first, It last) {
+		for (It it = first; it != last; ++it)
+			ensure_existing(it->first);
+		for (; first != last; ++first)
+			decrease_key(first->first, first->second);
+	}
+	/**
+	 * try to increase the key of the element with the given id.
+	 * It does nothing if newkey is smaller than the current key of the element.
+	 */
+	void increase_key(int id, const T& newkey) {
+		ensure_existing(id);
+		size_t i = pos[id];
+		if (!less(newkey, keys[i])) {
+			keys[i] = newkey;
+			sift_down(i);
+		}
+	}
+	void update_key(int id, const T& newkey) {
+		ensure_existing(id);
+		if (less(keys[pos[id]], newkey))
+			increase_key(id, newkey);
+		else
+			decrease_key(id, newkey);
+	}
+	bool try_insert(int id, const T& key) {
+		if (id < 0 || id >= maxsz || contains(id))
+			return false;
+		append(id, key);
+		sift_up(keys.size() - 1);
+		return true;
+	}
+	bool try_delete_min(Element &min) {
+		if (keys.empty())
+			return false;
+		min = take(0);
+		return true;
+	}
+	/**
+	 * calls fn(elem) for every element in the pq, in no particular order.
+	 * The elements are temporaries, valid during the call only.
+	 */
+	template<typename F>
+	void for_each(F fn) const {
+		for (size_t i = 0; i < keys.size(); ++i)
+			fn(Element(ids[i], keys[i]));
+	}
+	/**
+	 * starts to load the key of the element with the given id into the cache.
+	 * It does nothing if there's no element with that id.
+	 */
+	void prefetch(int id) const {
+		if (contains(id))
+			PH_PREFETCH(&keys[pos[id]]);
+	}
+};
+
+/**
+ * The following are possible exceptions.
+ */
+template<typename T, typename Comparator, int D>
+const PH_Exception DaryHeap<T, Comparator, D>::PH_EX_ALREADY_EXISTS(
+		"An element with the same ID already exists.");
+template<typename T, typename Comparator, int D>
+const PH_Exception DaryHeap<T, Comparator, D>::PH_EX_EMPTY(
+		"The heap is empty!");
+template<typename T, typename Comparator, int D>
+const PH_Exception DaryHeap<T, Comparator, D>::PH_EX_BAD_ID("ID out of range!");
+template<typename T, typename Comparator, int D>
+const PH_Exception DaryHeap<T, Comparator, D>::PH_EX_NO_SUCH_ELEMENT(
+		"The heap contains no element with this ID!");
+
+#endif /* DARYHEAP_H_ */
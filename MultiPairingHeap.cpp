@@ -0,0 +1,87 @@
+//============================================================================
+// Name        : MultiPairingHeap.cpp
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : Test program for MultiPairingHeap.h
+//============================================================================
+
+#include "MultiPairingHeap.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <ctime>
+using namespace std;
+
+const int threads = 4, mn = 20000, ops = 200000;
+
+/**
+ * all threads delete the minima, remove and decrease random elements at the same time,
+ * and put every element they took out back with a larger key. No id may be lost or doubled,
+ * and a key only changes by the operations on it.
+ */
+template<typename Q>
+bool stress() {
+	Q q(mn, 2 * threads);
+	for (int i = 0; i < mn; ++i)
+		q.insert(i, i);
+	vector<thread> ts;
+	vector<int> fails(threads);
+	for (int k = 0; k < threads; ++k)
+		ts.push_back(thread([&q, &fails, k]() {
+			unsigned r = k + 1;
+			typename Q::Element e;
+			for (int it = 0; it < ops; ++it) {
+				r = r * 1103515245 + 12345;
+				int id = (r >> 8) % mn;
+				try {
+					if (it % 3 == 0) {
+						if (q.try_delete_min(e))
+							q.insert(e.id, e.key + 5);
+					} else if (it % 3 == 1)
+						q.decrease_key(id, -int(r % 100));
+					else {
+						// the element is missing while another thread holds it.
+						e = q.remove(id);
+						fails[k] += e.id != id;
+						q.insert(id, e.key + 1);
+					}
+				} catch (PH_Exception &) {
+				}
+			}
+		}));
+	for (size_t i = 0; i < ts.size(); ++i)
+		ts[i].join();
+	bool ok = q.size() == mn;
+	for (int k = 0; k < threads; ++k)
+		ok = ok && fails[k] == 0;
+	vector<bool> seen(mn);
+	typename Q::Element e;
+	for (int n = 0; ok && q.try_delete_min(e); ++n) {
+		ok = !seen[e.id] && n < mn;
+		seen[e.id] = 1;
+	}
+	for (int i = 0; i < mn; ++i)
+		ok = ok && seen[i] && !q.contains(i);
+	// then single-threaded, every element comes out exactly once.
+	for (int i = 0; i < 1000; ++i)
+		q.insert(i, i);
+	long long sum = 0;
+	while (q.try_delete_min(e))
+		sum += e.key;
+	try {
+		q.delete_min();
+		ok = 0;
+	} catch (PH_Exception &) {
+	}
+	return ok && sum == 999 * 1000 / 2 && q.size() == 0;
+}
+
+int main() {
+	srand(time(0));
+	cout << "paged layout: " << stress<MultiPairingHeap<int> >() << endl;
+	cout << "pool, auxiliary: "
+			<< stress<MultiPairingHeap<int, less<int>, PH_PoolAlloc, PH_PagedLayout, PH_AuxTwoPass> >() << endl;
+	cout << "pointer layout: " << stress<MultiPairingHeap<int, less<int>, PH_NewAlloc, PH_PointerLayout> >() << endl;
+	return 0;
+}
@@ -0,0 +1,269 @@
+//============================================================================
+// Name        : MultiPairingHeap.h
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : relaxed concurrent priority queues made of pairing heaps
+//============================================================================
+
+#ifndef MULTIPAIRINGHEAP_H_
+#define MULTIPAIRINGHEAP_H_
+
+#include "PairingHeap.h"
+#include <atomic>
+#include <mutex>
+
+/**
+ * The class of relaxed concurrent priority queues made of several @PairingHeap's (a MultiQueue).
+ * All methods may be called from any number of threads at the same time.
+ * delete_min doesn't return the exact minimum, but one that is close to it with high probability,
+ * which is enough for e.g. parallel Dijkstra or delta-stepping.
+ *
+ * Algo:
+ * 		The elements are distributed over the queues, each one guarded by its own lock.
+ * 		insert locks a random queue, only ever with try_lock, and moves on to another one if it's taken.
+ * 		delete_min try-locks two random queues and deletes the smaller of their minima.
+ * 		A table of atomic ints maps each id to its queue, so that decrease_key and remove go to the right one.
+ * 		It's changed only while the lock of that queue is held.
+ *
+ * Template parameters:
+ * 		the same as @PairingHeap. The default PH_PagedLayout keeps the id maps of the queues small,
+ * 		since each queue only sees a sparse subset of the id's.
+ *
+ * Public methods:
+ * 		MultiPairingHeap(int max_size, int queues):
+ * 			the id's must be in [0, max_size). queues should be a small multiple of the number of threads, e.g. 2 or 4 times.
+ *		void insert(int id, const T& key):
+ *			try to insert an element with the given id and key.
+ *			Throws an exception if the id is invalid or there's already an element with that id.
+ *		bool try_delete_min(Element &min):
+ *			removes one of the smallest elements and stores it in min. Returns false if the pq is empty.
+ *		Element delete_min():
+ *			like try_delete_min, but throws an exception if the pq is empty.
+ * 		Element remove(int id):
+ *			removes and returns the element with the given id.
+ *	  		Throws an exception if the id is invalid or there's no element with that id.
+ *		void decrease_key(int id, const T& newkey):
+ *			try to decrease the key of the element with the given id. Like in @PairingHeap.
+ *		bool contains(int id):
+ *			determines whether there's an element with the given id. This won't throw any exceptions.
+ *		size_t size():
+ *			returns the number of elements. It's only exact while no other method is running.
+ */
+template<typename T, typename Comparator = std::less<T>,
+		template<typename > class NodeAlloc = PH_NewAlloc,
+		typename Layout = PH_PagedLayout, typename Variant = PH_TwoPass,
+		typename Stats = PH_NoStats>
+class MultiPairingHeap {
+public:
+	typedef PairingHeap<T, Comparator, NodeAlloc, Layout, Variant, Stats> Heap;
+	typedef typename Heap::Element Element;
+private:
+	/**
+	 * A queue with its lock, padded to avoid false sharing between the queues.
+	 */
+	struct Queue {
+		std::mutex m;
+		Heap h;
+		char pad[64];
+		Queue(int max_size) :
+				h(max_size) {
+		}
+	};
+
+	// the id's that are free, and that are claimed by an insert which hasn't finished yet.
+	enum {
+		FREE = -1, CLAIMED = -2
+	};
+
+	// the maximal size. Valid id's are in [0, maxsz).
+	int maxsz;
+	// the number of queues.
+	int nq;
+	Queue **qs;
+	// queue_of[id] is the queue of the element with this id, FREE or CLAIMED.
+	std::atomic<int> *queue_of;
+	// the number of elements.
+	std::atomic<int> sz;
+	// the comparator of the minima of two queues.
+	Comparator less;
+
+	// the possible exceptions. (initialized below out of the class)
+	static const PH_Exception PH_EX_EMPTY, PH_EX_BAD_ID, PH_EX_ALREADY_EXISTS,
+			PH_EX_NO_SUCH_ELEMENT;
+
+	// a random queue. Each thread has its own generator (xorshift), so there's no contention.
+	int random_queue() {
+		static thread_local unsigned seed = 0;
+		if (seed == 0)
+			seed = unsigned(reinterpret_cast<uintptr_t>(&seed) >> 4) | 1;
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return int(seed % unsigned(nq));
+	}
+	// locks some random queue with try_lock, and returns it.
+	int lock_random() {
+		for (;;) {
+			int i = random_queue();
+			if (qs[i]->m.try_lock())
+				return i;
+		}
+	}
+	/**
+	 * locks the queue of the element with the given id, and returns it.
+	 * Throws an exception if the id is invalid or there's no element with that id.
+	 */
+	int lock_queue_of(int id) {
+		if (id < 0 || id >= maxsz)
+			throw PH_EX_BAD_ID;
+		for (;;) {
+			int i = queue_of[id].load(std::memory_order_acquire);
+			if (i < 0)
+				throw PH_EX_NO_SUCH_ELEMENT;
+			qs[i]->m.lock();
+			// the element may have moved to another queue before we got the lock.
+			if (queue_of[id].load(std::memory_order_relaxed) == i)
+				return i;
+			qs[i]->m.unlock();
+		}
+	}
+
+	MultiPairingHeap(const MultiPairingHeap &) = delete;
+	MultiPairingHeap &operator=(const MultiPairingHeap &) = delete;
+public:
+	MultiPairingHeap(int max_size, int queues) :
+			maxsz(max_size), nq(std::max(queues, 1)), qs(new Queue *[nq]), queue_of(
+					new std::atomic<int>[max_size]), sz(0) {
+		for (int i = 0; i < max_size; ++i)
+			queue_of[i].store(FREE, std::memory_order_relaxed);
+		for (int i = 0; i < nq; ++i)
+			qs[i] = new Queue(max_size);
+	}
+	~MultiPairingHeap() {
+		for (int i = 0; i < nq; ++i)
+			delete qs[i];
+		delete[] qs;
+		delete[] queue_of;
+	}
+	size_t size() const {
+		return sz.load(std::memory_order_relaxed);
+	}
+	size_t max_size() const {
+		return maxsz;
+	}
+	size_t queues() const {
+		return nq;
+	}
+	bool contains(int id) const {
+		return id >= 0 && id < maxsz
+				&& queue_of[id].load(std::memory_order_acquire) >= 0;
+	}
+	/**
+	 * try to insert an element with the given id and key.
+	 * Throws an exception if the id is invalid or there's already an element with that id.
+	 */
+	void insert(int id, const T& key) {
+		if (id < 0 || id >= maxsz)
+			throw PH_EX_BAD_ID;
+		int expected = FREE;
+		if (!queue_of[id].compare_exchange_strong(expected, CLAIMED,
+				std::memory_order_acquire))
+			throw PH_EX_ALREADY_EXISTS;
+		int i = lock_random();
+		try {
+			qs[i]->h.insert_unchecked(id, key);
+		} catch (...) {
+			qs[i]->m.unlock();
+			queue_of[id].store(FREE, std::memory_order_release);
+			throw;
+		}
+		queue_of[id].store(i, std::memory_order_release);
+		sz.fetch_add(1, std::memory_order_relaxed);
+		qs[i]->m.unlock();
+	}
+	/**
+	 * removes one of the smallest elements and stores it in min.
+	 * Returns false if the pq is empty.
+	 * Algo:
+	 * 		try-lock two random queues, and delete the smaller of their minima.
+	 */
+	bool try_delete_min(Element &min) {
+		while (sz.load(std::memory_order_relaxed) > 0) {
+			int i = random_queue(), j = random_queue();
+			if (!qs[i]->m.try_lock())
+				continue;
+			if (j == i || !qs[j]->m.try_lock())
+				j = i;
+			Heap &a = qs[i]->h, &b = qs[j]->h;
+			Heap *best = b.size() == 0 ? &a : &b;
+			if (a.size() && b.size()
+					&& less(a.find_min().key, b.find_min().key))
+				best = &a;
+			bool found = best->size() != 0;
+			if (found) {
+				min = best->delete_min_unchecked();
+				queue_of[min.id].store(FREE, std::memory_order_release);
+				sz.fetch_sub(1, std::memory_order_relaxed);
+			}
+			if (j != i)
+				qs[j]->m.unlock();
+			qs[i]->m.unlock();
+			if (found)
+				return true;
+		}
+		return false;
+	}
+	/**
+	 * removes and returns one of the smallest elements.
+	 * Throws an exception if the pq is empty.
+	 */
+	Element delete_min() {
+		Element r;
+		if (!try_delete_min(r))
+			throw PH_EX_EMPTY;
+		return r;
+	}
+	/**
+	 * removes and returns the element with the given id.
+	 * Throws an exception if the id is invalid or there's no element with that id.
+	 */
+	Element remove(int id) {
+		int i = lock_queue_of(id);
+		Element r(qs[i]->h.remove_unchecked(id));
+		queue_of[id].store(FREE, std::memory_order_release);
+		sz.fetch_sub(1, std::memory_order_relaxed);
+		qs[i]->m.unlock();
+		return r;
+	}
+	/**
+	 * try to decrease the key of the element with the given id.
+	 * Throws an exception if the id is invalid or there's no element with that id.
+	 * It does nothing if newkey is larger than the current key of the element.
+	 */
+	void decrease_key(int id, const T& newkey) {
+		int i = lock_queue_of(id);
+		std::lock_guard<std::mutex> lock(qs[i]->m, std::adopt_lock);
+		qs[i]->h.decrease_key_unchecked(id, newkey);
+	}
+};
+
+/**
+ * The following are possible exceptions.
+ */
+template<typename T, typename Comparator, template<typename > class NodeAlloc,
+		typename Layout, typename Variant, typename Stats>
+const PH_Exception MultiPairingHeap<T, Comparator, NodeAlloc, Layout, Variant, Stats>::PH_EX_ALREADY_EXISTS(
+		"An element with the same ID already exists.");
+template<typename T, typename Comparator, template<typename > class NodeAlloc,
+		typename Layout, typename Variant, typename Stats>
+const PH_Exception MultiPairingHeap<T, Comparator, NodeAlloc, Layout, Variant, Stats>::PH_EX_EMPTY(
+		"The heap is empty!");
+template<typename T, typename Comparator, template<typename > class NodeAlloc,
+		typename Layout, typename Variant, typename Stats>
+const PH_Exception MultiPairingHeap<T, Comparator, NodeAlloc, Layout, Variant, Stats>::PH_EX_BAD_ID("ID out of range!");
+template<typename T, typename Comparator, template<typename > class NodeAlloc,
+		typename Layout, typename Variant, typename Stats>
+const PH_Exception MultiPairingHeap<T, Comparator, NodeAlloc, Layout, Variant, Stats>::PH_EX_NO_SUCH_ELEMENT(
+		"The heap contains no element with this ID!");
+
+#endif /* MULTIPAIRINGHEAP_H_ */
@@ -7,11 +7,17 @@
 
 #include "PairingHeap.h"
 #include <iostream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 #include <ctime>
 #include <functional>
+#include <iterator>
 using namespace std;
 
 const int mn = 1000000;
@@ -25,6 +31,537 @@ bool sorted(int n, int *a) {
 	return 1;
 }
 
+// the keys of the elements of a heap, in sorted order. The heap is copied and drained.
+template<typename H>
+vector<int> sorted_keys(const H &h) {
+	H c(h);
+	vector<int> r;
+	while (c.size())
+		r.push_back(c.delete_min().key);
+	return r;
+}
+template<typename R>
+vector<int> sorted_keys(const R &ref, size_t k) {
+	vector<int> r;
+	for (typename R::const_iterator it = ref.begin(); it != ref.end() && r.size() < k; ++it)
+		r.push_back(it->first);
+	return r;
+}
+
+// up to 20 (id, key)'s with distinct id's that aren't in the heap.
+template<typename H>
+vector<pair<int, int> > new_elements(const H &h, int n) {
+	vector<pair<int, int> > r;
+	for (int x = rand() % n, j = rand() % 20; j > 0; --j, x = (x + 7) % n)
+		if (!h.contains(x)) {
+			bool dup = 0;
+			for (size_t t = 0; t < r.size(); ++t)
+				dup |= r[t].first == x;
+			if (!dup)
+				r.push_back(make_pair(x, rand() % 10000));
+		}
+	return r;
+}
+
+/**
+ * random operations on a heap of type H with layout L against a std::set of (key, id).
+ * The heap grows on demand if grow is set.
+ */
+template<typename H, typename L>
+bool model(int ops, bool grow, L) {
+	const int n = 1000;
+	H *h = grow ? new H() : new H(n);
+	set<pair<int, int> > ref;
+	vector<int> key(n);
+	bool ok = 1;
+	for (int i = 0; i < ops && ok; ++i) {
+		int id = rand() % n, k = rand() % 10000, op = rand() % 17;
+		bool has = h->contains(id);
+		if (op < 3) {
+			try {
+				h->insert(id, k);
+				ok = !has;
+				ref.insert(make_pair(key[id] = k, id));
+			} catch (exception &) {
+				ok = has;
+			}
+		} else if (op < 5) {
+			typename H::Element e;
+			if (h->try_delete_min(e) != !ref.empty())
+				ok = 0;
+			else if (!ref.empty()) {
+				ok = e.key == ref.begin()->first && ref.erase(make_pair(e.key, e.id));
+			}
+		} else if (op == 5 && has) {
+			ok = h->remove(id).key == key[id];
+			ref.erase(make_pair(key[id], id));
+		} else if (op < 9 && has) {
+			ref.erase(make_pair(key[id], id));
+			int nk = key[id] + rand() % 200 - 100;
+			if (op == 6)
+				h->decrease_key(id, nk);
+			else if (op == 7)
+				h->increase_key(id, nk);
+			else
+				h->update_key(id, nk);
+			if (op == 8 || (op == 6) == (nk < key[id]))
+				key[id] = nk;
+			ref.insert(make_pair(key[id], id));
+		} else if (op == 9) {
+			vector<pair<int, int> > batch;
+			for (int j = rand() % 8; j > 0; --j) {
+				int x = rand() % n;
+				if (h->contains(x))
+					batch.push_back(make_pair(x, key[x] - rand() % 100));
+			}
+			h->decrease_key_batch(batch.begin(), batch.end());
+			for (size_t j = 0; j < batch.size(); ++j) {
+				int x = batch[j].first;
+				if (batch[j].second < key[x]) {
+					ref.erase(make_pair(key[x], x));
+					ref.insert(make_pair(key[x] = batch[j].second, x));
+				}
+			}
+		} else if (op == 10) {
+			vector<pair<int, int> > bulk = new_elements(*h, n);
+			h->insert_bulk(bulk.begin(), bulk.end());
+			for (size_t j = 0; j < bulk.size(); ++j)
+				ref.insert(make_pair(key[bulk[j].first] = bulk[j].second, bulk[j].first));
+		} else if (op == 11 && rand() % 20 == 0) {
+			ok = sorted_keys(*h) == sorted_keys(ref, ref.size());
+		} else if (op == 12) {
+			vector<typename H::Element> out;
+			size_t k = rand() % 5;
+			h->peek_k(k, back_inserter(out));
+			vector<int> got;
+			for (size_t j = 0; j < out.size(); ++j)
+				got.push_back(out[j].key);
+			ok = got == sorted_keys(ref, k);
+		} else if (op == 13 && rand() % 4 == 0) {
+			vector<typename H::Element> out;
+			h->extract_k(rand() % 5, back_inserter(out));
+			for (size_t j = 0; j < out.size() && ok; ++j) {
+				ok = out[j].key == ref.begin()->first && ref.erase(make_pair(out[j].key, out[j].id));
+			}
+		} else if (op == 14 && rand() % 50 == 0) {
+			H *c = new H(*h);
+			delete h;
+			h = c;
+		} else if (op == 15) {
+			// a heap of new id's, less its minimum, melded into this one.
+			vector<pair<int, int> > bulk = new_elements(*h, n);
+			H other(n);
+			for (size_t j = 0; j < bulk.size(); ++j)
+				other.insert(bulk[j].first, bulk[j].second);
+			if (!bulk.empty()) {
+				int x = other.delete_min().id;
+				for (size_t j = 0; j < bulk.size(); ++j)
+					if (bulk[j].first == x)
+						bulk.erase(bulk.begin() + j);
+			}
+			h->meld(other);
+			ok = other.size() == 0;
+			for (size_t j = 0; j < bulk.size(); ++j)
+				ref.insert(make_pair(key[bulk[j].first] = bulk[j].second, bulk[j].first));
+		} else if (op == 16 && !ref.empty()) {
+			// a bound below, at or above the minimum.
+			int m = ref.begin()->first, bound = rand() % 3 == 0 ? m - 1 : rand() % 2 ? m : m + rand() % 200;
+			vector<typename H::Element> out;
+			h->extract_until(bound, back_inserter(out));
+			for (size_t j = 0; j < out.size() && ok; ++j) {
+				ok = out[j].key == ref.begin()->first && ref.erase(make_pair(out[j].key, out[j].id));
+			}
+			ok = ok && out.empty() == (bound < m) && (ref.empty() || ref.begin()->first > bound);
+		} else if (has)
+			ok = h->get_key(id) == key[id] && h->find_min().key == ref.begin()->first;
+		ok = ok && h->size() == ref.size();
+	}
+	if (ok) {
+		vector<typename H::Element> out;
+		h->drain_sorted(back_inserter(out));
+		ok = out.size() == ref.size();
+		for (size_t j = 0; j < out.size() && ok; ++j)
+			ok = out[j].key == ref.begin()->first && ref.erase(make_pair(out[j].key, out[j].id));
+	}
+	delete h;
+	return ok;
+}
+
+/**
+ * the same for PH_HandleLayout, whose elements are only addressed by the handles insert returns.
+ * The handles of a melded heap must go on working in this one, and so must all of them across reserve and shrink_to_fit.
+ */
+template<typename H>
+bool model(int ops, bool grow, PH_HandleLayout) {
+	const int n = 1000;
+	H *h = grow ? new H() : new H(n);
+	set<pair<int, int> > ref;
+	vector<int> key(n);
+	// the handle of each id, or none.
+	vector<typename H::Handle> hs(n);
+	bool ok = 1;
+	for (int i = 0; i < ops && ok; ++i) {
+		int id = rand() % n, k = rand() % 10000, op = rand() % 13;
+		bool has = hs[id] != typename H::Handle();
+		if (op < 3 && !has) {
+			hs[id] = h->insert(id, k);
+			ref.insert(make_pair(key[id] = k, id));
+		} else if (op < 5) {
+			typename H::Element e;
+			if (h->try_delete_min(e) != !ref.empty())
+				ok = 0;
+			else if (!ref.empty()) {
+				ok = e.key == ref.begin()->first && ref.erase(make_pair(e.key, e.id));
+				hs[e.id] = typename H::Handle();
+			}
+		} else if (op == 5 && has) {
+			typename H::Element e = h->remove(hs[id]);
+			ok = int(e.id) == id && e.key == key[id];
+			ref.erase(make_pair(key[id], id));
+			hs[id] = typename H::Handle();
+		} else if (op < 9 && has) {
+			ref.erase(make_pair(key[id], id));
+			int nk = key[id] + rand() % 200 - 100;
+			if (op == 6)
+				h->decrease_key(hs[id], nk);
+			else if (op == 7)
+				h->increase_key(hs[id], nk);
+			else
+				h->update_key(hs[id], nk);
+			if (op == 8 || (op == 6) == (nk < key[id]))
+				key[id] = nk;
+			ref.insert(make_pair(key[id], id));
+		} else if (op == 9) {
+			H other(n);
+			for (int j = rand() % 20; j > 0; --j) {
+				int x = rand() % n;
+				if (hs[x] == typename H::Handle()) {
+					hs[x] = other.insert(x, rand() % 10000);
+					ref.insert(make_pair(key[x] = other.get_key(hs[x]), x));
+				}
+			}
+			h->meld(other);
+			ok = other.size() == 0;
+		} else if (op == 10 && rand() % 50 == 0) {
+			if (rand() % 2)
+				h->reserve(h->size() + rand() % 2000);
+			else
+				h->shrink_to_fit();
+		} else if (op == 11) {
+			// there's no map, so the id's are unknown.
+			try {
+				h->remove(id);
+				ok = 0;
+			} catch (PH_Exception &) {
+				ok = !h->contains(id);
+			}
+		} else if (has)
+			ok = int(h->get(hs[id]).id) == id && h->get_key(hs[id]) == key[id] && h->find_min().key == ref.begin()->first;
+		ok = ok && h->size() == ref.size();
+	}
+	while (ok && h->size()) {
+		typename H::Element e = h->delete_min();
+		ok = e.key == ref.begin()->first && ref.erase(make_pair(e.key, e.id));
+	}
+	delete h;
+	return ok && ref.empty();
+}
+
+// the handles of PH_IndexLayout stay valid across meld, reserve and shrink_to_fit, as they are the id's.
+bool index_handles() {
+	typedef PairingHeap<int, less<int>, PH_NewAlloc, PH_IndexLayout> H;
+	const int n = 3000;
+	H pq, other;
+	vector<H::Handle> hs(n);
+	vector<int> key(n);
+	// the other heap has the larger array, which the melded one takes over.
+	for (int i = 0; i < n; ++i)
+		hs[i] = (i < 1000 ? pq : other).insert(i, key[i] = rand() % 10000);
+	pq.reserve(2 * n);
+	pq.meld(other);
+	bool ok = other.size() == 0 && pq.size() == size_t(n);
+	for (int i = 0; i < n; i += 3)
+		pq.decrease_key(hs[i], key[i] -= 5000);
+	for (int i = n / 2; i < n; ++i)
+		pq.remove(hs[i]);
+	pq.shrink_to_fit();
+	for (int i = 0; i < n / 2 && ok; ++i)
+		ok = pq.get(hs[i]).id == i && pq.get_key(hs[i]) == key[i] && pq.handle(i) == hs[i];
+	pq.reserve(2 * n);
+	for (int i = 0; i < n / 2; i += 2)
+		pq.update_key(hs[i], key[i] = rand() % 10000);
+	for (int last = -10000; ok && pq.size();) {
+		H::Element e = pq.remove(pq.handle(pq.find_min().id));
+		ok = e.key >= last && e.key == key[e.id];
+		last = e.key;
+	}
+	return ok;
+}
+
+/**
+ * reserve, fill, drain all but a few nodes, meld, shrink and drain again: the shrink gives back the empty slabs
+ * and pages, the nodes left keep their id's and keys, the rest of the room is used again,
+ * and an emptied heap gives its memory back.
+ */
+template<template<typename > class A, typename L>
+bool shrink() {
+	typedef PairingHeap<int, less<int>, A, L> H;
+	const int n = 20000;
+	H pq(n), other(n);
+	set<pair<int, int> > ref;
+	vector<int> key(n);
+	pq.reserve(n / 2);
+	for (int i = 0; i < n; ++i) {
+		(i < n / 2 ? pq : other).insert(i, key[i] = rand() % 100000);
+		ref.insert(make_pair(key[i], i));
+	}
+	bool ok = 1;
+	while (ok && pq.size() > 10) {
+		typename H::Element e = pq.delete_min();
+		ok = ref.erase(make_pair(e.key, e.id));
+	}
+	// the nodes left of other are spread over all of its slabs.
+	for (int i = n / 2; i < n; ++i)
+		if (i % 1000)
+			ref.erase(make_pair(other.remove(i).key, i));
+	pq.meld(other);
+	size_t before = pq.memory_bytes();
+	pq.shrink_to_fit();
+	ok = ok && pq.size() == ref.size() && pq.memory_bytes() < before;
+	for (set<pair<int, int> >::iterator it = ref.begin(); it != ref.end() && ok; ++it)
+		ok = pq.contains(it->second) && pq.get_key(it->second) == it->first;
+	for (int i = 0; i < n; i += 7)
+		if (!pq.contains(i)) {
+			pq.insert(i, key[i] = rand() % 100000);
+			ref.insert(make_pair(key[i], i));
+		}
+	while (ok && pq.size()) {
+		typename H::Element e = pq.delete_min();
+		ok = e.key == ref.begin()->first && ref.erase(make_pair(e.key, e.id));
+	}
+	pq.clear();
+	before = pq.memory_bytes();
+	pq.shrink_to_fit();
+	return ok && ref.empty() && pq.memory_bytes() < before;
+}
+
+// a plain comparator, whose links aren't selected without a branch like those of std::less.
+struct IntLess {
+	bool operator()(int a, int b) const {
+		return a < b;
+	}
+};
+
+// elements with equal keys and shuffled id's, from insert, insert_bulk, meld and decrease_key, come out by id.
+template<typename C, typename V>
+bool ties() {
+	typedef PairingHeap<int, PH_IdTieBreak<C>, PH_NewAlloc, PH_PointerLayout, V> H;
+	const int n = 600;
+	vector<int> ids(n);
+	for (int i = 0; i < n; ++i)
+		ids[i] = i;
+	for (int i = n - 1; i > 0; --i)
+		swap(ids[i], ids[rand() % (i + 1)]);
+	H pq(n), other(n);
+	vector<pair<int, int> > bulk;
+	for (int i = 0; i < n; ++i) {
+		int id = ids[i];
+		if (i < n / 3)
+			pq.insert(id, id % 4);
+		else if (i < 2 * n / 3)
+			bulk.push_back(make_pair(id, id % 4));
+		else
+			other.insert(id, id % 4);
+	}
+	pq.insert_bulk(bulk.begin(), bulk.end());
+	pq.meld(other);
+	// half of the elements of key 3 join those of key 0.
+	for (int i = n - 1; i >= 0; --i)
+		if (ids[i] % 8 == 3)
+			pq.decrease_key(ids[i], 0);
+	bool ok = pq.size() == size_t(n);
+	for (int k = -1, id = -1; ok && pq.size();) {
+		typename H::Element e = pq.delete_min();
+		ok = e.key == (e.id % 8 == 3 ? 0 : e.id % 4) && (e.key > k || (e.key == k && e.id > id));
+		k = e.key;
+		id = e.id;
+	}
+	return ok;
+}
+
+// a key whose copies throw after a countdown, counting the live objects.
+struct Fragile {
+	static int live, countdown;
+	int v;
+	Fragile(int v) :
+			v(v) {
+		++live;
+	}
+	Fragile(const Fragile &o) :
+			v(o.v) {
+		if (countdown >= 0 && countdown-- == 0)
+			throw runtime_error("copy of a fragile key");
+		++live;
+	}
+	~Fragile() {
+		--live;
+	}
+	bool operator<(const Fragile &o) const {
+		return v < o.v;
+	}
+};
+int Fragile::live = 0, Fragile::countdown = -1;
+
+// a failed copy of a key leaves no node behind, neither in insert nor in the copy of a heap.
+template<template<typename > class A, typename L>
+bool fragile() {
+	typedef PairingHeap<Fragile, less<Fragile>, A, L> H;
+	bool ok = 1;
+	{
+		H pq(100);
+		for (int i = 0; i < 50; ++i)
+			pq.insert(i, Fragile(rand() % 100));
+		for (int i = 0; i < 10; ++i)
+			pq.delete_min();
+		Fragile k(7);
+		Fragile::countdown = 0;
+		try {
+			pq.insert(60, k);
+			ok = 0;
+		} catch (runtime_error &) {
+			ok = ok && !pq.contains(60) && pq.size() == 40;
+		}
+		for (int n = 0; n < 40 && ok; n += 7) {
+			Fragile::countdown = n;
+			try {
+				H c(pq);
+				ok = 0;
+			} catch (runtime_error &) {
+			}
+		}
+		Fragile::countdown = -1;
+		H c(pq);
+		while (ok && c.size())
+			ok = c.delete_min().key.v == pq.delete_min().key.v;
+	}
+	return ok && Fragile::live == 0;
+}
+
+/**
+ * save and both loads give back the same elements in the same trees, and an uncovered id after
+ * an in-place load moves the nodes away from the image. Short images and a bad header are rejected.
+ */
+template<typename V>
+bool snapshots() {
+	typedef PairingHeap<int, less<int>, PH_NewAlloc, PH_IndexLayout, V> H;
+	H pq;
+	for (int i = 0; i < 1000; ++i)
+		pq.try_insert(rand() % 1000, rand() % 10000);
+	for (int i = 0; i < 100; ++i)
+		pq.delete_min();
+	for (int i = 0; i < 1000; i += 7)
+		if (pq.contains(i))
+			pq.decrease_key(i, pq.get_key(i) - 5000);
+	stringstream ss;
+	pq.save(ss);
+	string img = ss.str();
+	bool ok = 1;
+	{
+		H g(10);
+		g.insert(3, 3);
+		istringstream in(img);
+		g.load(in);
+		ok = ok && g.max_size() == pq.max_size() && sorted_keys(g) == sorted_keys(pq);
+	}
+	// the image must be aligned like a node, so it's copied to an array of long long's.
+	vector<long long> buf(img.size() / sizeof(long long) + 1);
+	memcpy(&buf[0], img.data(), img.size());
+	{
+		H g;
+		g.load(&buf[0], img.size());
+		ok = ok && sorted_keys(g) == sorted_keys(pq);
+		size_t left = pq.size();
+		for (int i = 0; i < 500; ++i)
+			if (g.contains(i))
+				g.remove(i), --left;
+		g.insert(5000, -10000);
+		ok = ok && g.size() == left + 1 && g.delete_min().id == 5000;
+	}
+	// a short stream, a short image, a bad header and the keys of another type.
+	for (int t = 0; t < 4; ++t) {
+		try {
+			if (t == 0) {
+				H g;
+				istringstream in(img.substr(0, img.size() - 1));
+				g.load(in);
+			} else if (t == 1) {
+				H g;
+				g.load(&buf[0], img.size() - sizeof(int));
+			} else if (t == 2) {
+				string bad = img;
+				bad[0] = 'X';
+				H g;
+				istringstream in(bad);
+				g.load(in);
+			} else {
+				PairingHeap<long long, less<long long>, PH_NewAlloc, PH_IndexLayout, V> g;
+				istringstream in(img);
+				g.load(in);
+			}
+			ok = 0;
+		} catch (PH_Exception &) {
+		}
+	}
+	return ok;
+}
+
+// inserts the id's [from, from + 1023) into an incremental heap and returns the number of trees find_min combines.
+template<typename H>
+unsigned long long aux_trees(H &pq, int from) {
+	for (int i = from; i < from + 1023; ++i)
+		pq.insert(i, rand());
+	unsigned long long before = pq.stats().combined_siblings;
+	pq.find_min();
+	return pq.stats().combined_siblings - before;
+}
+
+// a copy of an incremental heap keeps its auxiliary trees in the counter, like the original.
+template<typename L>
+bool copied_counter() {
+	typedef PairingHeap<int, less<int>, PH_NewAlloc, L, PH_Incremental<PH_TwoPass>, PH_CountStats> H;
+	H pq(4096);
+	for (int i = 0; i < 1023; ++i)
+		pq.insert(i, rand());
+	H c(pq);
+	return aux_trees(c, 1023) == aux_trees(pq, 1023);
+}
+// a loaded snapshot puts the auxiliary trees into the counter, so there are no more of them than in the original.
+bool loaded_counter() {
+	typedef PairingHeap<int, less<int>, PH_NewAlloc, PH_IndexLayout, PH_Incremental<PH_TwoPass>, PH_CountStats> H;
+	H pq(4096);
+	for (int i = 0; i < 1023; ++i)
+		pq.insert(i, rand());
+	stringstream ss;
+	pq.save(ss);
+	H g;
+	g.load(ss);
+	return aux_trees(g, 1023) <= aux_trees(pq, 1023);
+}
+
+// runs model for the variants with the given allocator and layout.
+template<template<typename > class A, typename L>
+void models(const char *name, bool grow) {
+	cout << name << ": " << model<PairingHeap<int, less<int>, A, L> >(50000, grow, L());
+	cout << model<PairingHeap<int, less<int>, A, L, PH_FrontToBack> >(50000, grow, L());
+	cout << model<PairingHeap<int, less<int>, A, L, PH_MultiPass> >(50000, grow, L());
+	cout << model<PairingHeap<int, less<int>, A, L, PH_AuxTwoPass> >(50000, grow, L());
+	cout << model<PairingHeap<int, less<int>, A, L, PH_AuxMultiPass> >(50000, grow, L());
+	cout << model<PairingHeap<int, less<int>, A, L, PH_Prefetching<PH_TwoPass> > >(50000, grow, L());
+	cout << model<PairingHeap<int, less<int>, A, L, PH_Incremental<PH_TwoPass> > >(50000, grow, L());
+	cout << model<PairingHeap<int, PH_IdTieBreak<less<int> >, A, L, PH_AuxTwoPass, PH_CountStats, uint32_t> >(50000, grow, L());
+	cout << endl;
+}
+
 int main() {
 	srand(time(0));
 	PairingHeap<int> pq(mn);
@@ -71,5 +608,27 @@ int main() {
 	cout << "size = " << pq.size() << endl;
 //	cout<<endl;
 	cout << sorted(mn, b) << endl;
+
+	// every layout with every variant, against a reference.
+	models<PH_NewAlloc, PH_PointerLayout>("pointer layout", 0);
+	models<PH_PoolAlloc, PH_PointerLayout>("pointer layout, pool", 1);
+	models<PH_NewAlloc, PH_IndexLayout>("index layout", 1);
+	models<PH_PoolAlloc, PH_PagedLayout>("paged layout, pool", 1);
+	models<PH_NewAlloc, PH_HandleLayout>("handle layout", 0);
+	models<PH_PoolAlloc, PH_HandleLayout>("handle layout, pool", 1);
+	cout << "index handles: " << index_handles() << endl;
+	cout << "shrink: " << shrink<PH_PoolAlloc, PH_PointerLayout>() << shrink<PH_PoolAlloc, PH_PagedLayout>()
+			<< shrink<PH_NewAlloc, PH_PagedLayout>() << endl;
+	cout << "id ties: " << ties<less<int>, PH_TwoPass>() << ties<less<int>, PH_FrontToBack>()
+			<< ties<less<int>, PH_MultiPass>() << ties<less<int>, PH_AuxTwoPass>() << ties<less<int>, PH_AuxMultiPass>()
+			<< ties<less<int>, PH_Prefetching<PH_TwoPass> >() << ties<less<int>, PH_Incremental<PH_TwoPass> >()
+			<< ties<IntLess, PH_TwoPass>() << ties<IntLess, PH_AuxMultiPass>() << endl;
+	cout << "snapshots: " << snapshots<PH_TwoPass>() << snapshots<PH_AuxTwoPass>()
+			<< snapshots<PH_Prefetching<PH_MultiPass> >() << endl;
+	cout << "incremental counters: " << copied_counter<PH_PointerLayout>() << copied_counter<PH_IndexLayout>()
+			<< loaded_counter() << endl;
+	cout << "throwing keys: " << fragile<PH_NewAlloc, PH_PointerLayout>() << fragile<PH_PoolAlloc, PH_PointerLayout>()
+			<< fragile<PH_NewAlloc, PH_IndexLayout>()
+			<< fragile<PH_PoolAlloc, PH_PagedLayout>() << endl;
 	return 0;
 }
@@ -10,8 +10,28 @@
 
 #include <cstring>
 #include <functional>
+#include <istream>
+#include <ostream>
 #include <exception>
 #include <algorithm>
+#include <new>
+#include <cassert>
+#include <cstdlib>
+#include <climits>
+#include <limits>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Prefetches the cache line at address a for reading, where the compiler supports it.
+ */
+#if defined(__GNUC__)
+#define PH_PREFETCH(a) __builtin_prefetch(a)
+#else
+#define PH_PREFETCH(a) ((void) 0)
+#endif
 
 /**
  * The class of possible exceptions when using @PairingHeap.
@@ -27,6 +47,1083 @@ public:
 	}
 };
 
+/**
+ * Node allocation policies for @PairingHeap.
+ * A policy is a class template over the node type and provides:
+ * 		NodeAlloc(size_t max_size):
+ * 			max_size is the maximal number of nodes alive at the same time.
+ * 		void *allocate():
+ * 			returns raw memory for one node.
+ * 		void deallocate(void *p):
+ * 			gives back the memory of a node obtained from allocate().
+ * 		void take_over(NodeAlloc &other):
+ * 			becomes responsible for the nodes of other, which is left empty.
+ * 		size_t memory_bytes():
+ * 			returns the number of bytes held for the nodes, in use or not.
+ * 		void reserve(size_t n):
+ * 			makes room for n more nodes, so that allocating them doesn't go to the system.
+ * 		void shrink_to_fit():
+ * 			gives back the memory held for nodes not in use, as far as it can without moving any node.
+ */
+
+/**
+ * Every node comes from (and goes back to) the global heap.
+ * Nothing is held beyond the nodes in use; the overhead of the global heap isn't counted.
+ */
+template<typename Node>
+class PH_NewAlloc {
+	// the number of nodes in use.
+	size_t live;
+public:
+	PH_NewAlloc(size_t) :
+			live(0) {
+	}
+	void *allocate() {
+		void *p = ::operator new(sizeof(Node));
+		++live;
+		return p;
+	}
+	void deallocate(void *p) {
+		::operator delete(p);
+		--live;
+	}
+	void take_over(PH_NewAlloc &other) {
+		live += other.live;
+		other.live = 0;
+	}
+	size_t memory_bytes() const {
+		return live * sizeof(Node);
+	}
+	void reserve(size_t) {
+	}
+	void shrink_to_fit() {
+	}
+};
+
+/**
+ * Nodes are cut out of slabs which are only released when the allocator dies, or by shrink_to_fit.
+ * Freed nodes are kept in an intrusive free list and reused first.
+ * The slabs grow geometrically but never hold more than max_size nodes in total,
+ * so a heap that is filled up to max_size ends up with O(log(max_size)) slabs.
+ */
+template<typename Node>
+class PH_PoolAlloc {
+	// the number of nodes in the first slab.
+	static const size_t FIRST_SLAB = 64;
+
+	// the first slots of every slab hold the pointer to the previous slab and the number of its nodes.
+	struct Header {
+		char *prev;
+		size_t n;
+	};
+	static const size_t HEADER = (sizeof(Header) + sizeof(Node) - 1)
+			/ sizeof(Node) * sizeof(Node);
+
+	// the number of nodes the slabs may hold in total, and may still hold.
+	size_t max_nodes, left;
+	// the size of the next slab.
+	size_t next_slab;
+	// the bytes of all slabs.
+	size_t bytes;
+	// the current slab, and the range of its never used slots.
+	char *slab, *cur, *end;
+	// the list of freed nodes and its length. Each one stores the pointer to the next one.
+	void *free_list, *free_tail;
+	size_t nfree;
+
+	PH_PoolAlloc(const PH_PoolAlloc &);
+	PH_PoolAlloc &operator=(const PH_PoolAlloc &);
+
+	static Header &header(char *s) {
+		return *reinterpret_cast<Header *>(s);
+	}
+	// allocates a new slab of (at most) n nodes and makes it the current one.
+	void grow(size_t n) {
+		n = std::min(n, left);
+		if (n == 0)
+			throw std::bad_alloc();
+		size_t b = HEADER + sizeof(Node) * n;
+		char *s = static_cast<char *>(::operator new(b));
+		header(s).prev = slab;
+		header(s).n = n;
+		slab = s;
+		cur = s + HEADER;
+		end = cur + sizeof(Node) * n;
+		left -= n;
+		bytes += b;
+	}
+	// puts the never used slots of the current slab into the free list.
+	void retire() {
+		for (; cur != end; cur += sizeof(Node))
+			deallocate(cur);
+		cur = end = 0;
+	}
+public:
+	PH_PoolAlloc(size_t max_size) :
+			max_nodes(max_size), left(max_size), next_slab(FIRST_SLAB), bytes(
+					0), slab(0), cur(0), end(0), free_list(0), free_tail(0), nfree(
+					0) {
+	}
+	~PH_PoolAlloc() {
+		while (slab) {
+			char *prev = header(slab).prev;
+			::operator delete(slab);
+			slab = prev;
+		}
+	}
+	void *allocate() {
+		if (free_list) {
+			void *p = free_list;
+			free_list = *static_cast<void **>(p);
+			--nfree;
+			return p;
+		}
+		if (cur == end) {
+			grow(next_slab);
+			next_slab *= 2;
+		}
+		void *p = cur;
+		cur += sizeof(Node);
+		return p;
+	}
+	void deallocate(void *p) {
+		if (free_list == 0)
+			free_tail = p;
+		*static_cast<void **>(p) = free_list;
+		free_list = p;
+		++nfree;
+	}
+	/**
+	 * Splices the slabs and the free list of other into this allocator.
+	 * The smaller one of the two ranges of never used slots is put into the free list.
+	 * Takes O(number of slabs of other) time, plus the size of that range.
+	 */
+	void take_over(PH_PoolAlloc &other) {
+		if (other.slab) {
+			char *s = other.slab;
+			while (header(s).prev)
+				s = header(s).prev;
+			header(s).prev = slab;
+			slab = other.slab;
+		}
+		if (other.free_list) {
+			*static_cast<void **>(other.free_tail) = free_list;
+			if (free_list == 0)
+				free_tail = other.free_tail;
+			free_list = other.free_list;
+			nfree += other.nfree;
+		}
+		if (other.end - other.cur > end - cur) {
+			std::swap(cur, other.cur);
+			std::swap(end, other.end);
+		}
+		for (; other.cur != other.end; other.cur += sizeof(Node))
+			deallocate(other.cur);
+		left += std::min(other.left, size_t(-1) - left);
+		next_slab = std::max(next_slab, other.next_slab);
+		bytes += other.bytes;
+		// other starts over, as it has no slabs left. (e.g. when it's melded into this one again and again)
+		other.left = other.max_nodes;
+		other.next_slab = FIRST_SLAB;
+		other.bytes = other.nfree = 0;
+		other.slab = other.cur = other.end = 0;
+		other.free_list = other.free_tail = 0;
+	}
+	size_t memory_bytes() const {
+		return bytes;
+	}
+	// the missing room comes in one slab, as far as max_size allows.
+	void reserve(size_t n) {
+		size_t room = nfree + (end - cur) / sizeof(Node);
+		if (room >= n || left == 0)
+			return;
+		retire();
+		grow(n - room);
+	}
+	/**
+	 * Releases the slabs none of whose nodes is in use, and sorts the free list by address.
+	 * Algo:
+	 * 		sort the free nodes, and count those of each slab by binary search.
+	 * 		Takes O(f log f + s log f) time for f free nodes and s slabs, and O(f) extra space.
+	 */
+	void shrink_to_fit() {
+		retire();
+		std::vector<char *> fr;
+		fr.reserve(nfree);
+		for (void *p = free_list; p; p = *static_cast<void **>(p))
+			fr.push_back(static_cast<char *>(p));
+		std::less<char *> before;
+		std::sort(fr.begin(), fr.end(), before);
+		// whether the free node stays, i.e. its slab isn't released.
+		std::vector<bool> keep(fr.size(), true);
+		for (char **s = &slab; *s;) {
+			Header &h = header(*s);
+			char *first = *s + HEADER, *last = first + sizeof(Node) * h.n;
+			std::vector<char *>::iterator lo = std::lower_bound(fr.begin(),
+					fr.end(), first, before), hi = std::lower_bound(lo, fr.end(),
+					last, before);
+			if (size_t(hi - lo) < h.n) {
+				s = &h.prev;
+				continue;
+			}
+			std::fill(keep.begin() + (lo - fr.begin()),
+					keep.begin() + (hi - fr.begin()), false);
+			char *dead = *s;
+			*s = h.prev;
+			left += h.n;
+			bytes -= HEADER + sizeof(Node) * h.n;
+			::operator delete(dead);
+		}
+		free_list = free_tail = 0;
+		nfree = 0;
+		for (size_t i = fr.size(); i-- > 0;)
+			if (keep[i])
+				deallocate(fr[i]);
+		if (slab == 0)
+			next_slab = FIRST_SLAB;
+	}
+};
+
+/**
+ * Node layout policies for @PairingHeap.
+ * A layout decides how the nodes are stored and linked, and how an id is mapped to its node.
+ * Layout::storage<Element, NodeAlloc> provides, with the type id_type of the id's, Element::id_type:
+ * 		typedef ... link:
+ * 			refers to a node. 0 is the null link.
+ * 		typedef ... node:
+ * 			has the element elem and the links parent, left, right and son.
+ * 		static const bool by_id:
+ * 			whether there's a map from the id's to the nodes. If not, find always returns 0 and for_each isn't provided.
+ * 		static const bool by_index:
+ * 			whether the links are indices into one array, which stay valid in a copy of it. If so, there's
+ * 			void copy(const storage &other), which makes an empty storage a copy of other with the same links.
+ * 		storage(size_t max_size):
+ * 			the id's 0, 1, ..., max_size-1 are covered from the start.
+ * 		storage():
+ * 			no id is covered from the start.
+ * 		node &operator[](link x):
+ * 			the node x refers to.
+ * 		link find(id_type id):
+ * 			the node with the given non-negative id, or 0 if there's none.
+ * 		void prefetch(id_type id):
+ * 			starts to load the node with the given non-negative id into the cache, if there's one.
+ * 		link create(id_type id, Args&&... args):
+ * 			makes a node for the element Element(id, args...), constructed in place.
+ * 			Its siblings list contains only itself and it has no parent or son.
+ * 			The space for the addressability grows in amortized O(1) time if id isn't covered yet.
+ * 		void destroy(link x):
+ * 			disposes the node x.
+ * 		void take_over(storage &other):
+ * 			takes over the nodes and the id's of other, which must be disjoint from the own id's.
+ * 			The links into the nodes of other stay valid, and other is left empty.
+ * 		void for_each(F f):
+ * 			calls f(elem) for the element of every node, in the order of the map from the id's to the nodes.
+ * 		size_t memory_bytes():
+ * 			returns the number of bytes held by the map and the nodes.
+ * 		void reserve(size_t ids, size_t nodes):
+ * 			covers the id's 0, 1, ..., ids-1, and makes room for nodes more nodes.
+ * 		void shrink_to_fit():
+ * 			gives back the space of the id's above the largest one in use, and of the nodes not in use.
+ * 			The links into the nodes in use stay valid.
+ */
+
+/**
+ * Every node is allocated with NodeAlloc and the links are plain pointers.
+ * An extra array maps the id's to the nodes. It is at least doubled when it grows.
+ */
+struct PH_PointerLayout {
+	template<typename Element, template<typename > class NodeAlloc>
+	class storage {
+	public:
+		typedef typename Element::id_type id_type;
+		static const bool by_id = true;
+		static const bool by_index = false;
+		struct node {
+			Element elem;
+			node *parent, *left, *right, *son;
+			template<typename ... Args>
+			node(id_type id, Args&&... args) :
+					elem(id, std::forward<Args>(args)...), parent(0), left(this), right(
+							this), son(0) {
+			}
+			// constructs a node in memory from alloc, which gets it back if the element can't be constructed.
+			template<typename A, typename ... Args>
+			static node *make(A &alloc, id_type id, Args&&... args) {
+				void *m = alloc.allocate();
+				try {
+					return new (m) node(id, std::forward<Args>(args)...);
+				} catch (...) {
+					alloc.deallocate(m);
+					throw;
+				}
+			}
+		};
+		typedef node *link;
+	private:
+		// pos[i] is the address of the node with element with id = i, for i < cap.
+		node **pos;
+		size_t cap;
+		// where the nodes come from.
+		NodeAlloc<node> alloc;
+
+		storage(const storage &);
+		storage &operator=(const storage &);
+
+		// makes pos cover id.
+		void grow(id_type id) {
+			resize(std::max(size_t(id) + 1, 2 * cap));
+		}
+		// makes pos cover the id's 0, 1, ..., n-1, and no more.
+		void resize(size_t n) {
+			if (n == 0) {
+				free(pos);
+				pos = 0;
+				cap = 0;
+				return;
+			}
+			node **p = static_cast<node **>(realloc(pos, n * sizeof(node*)));
+			if (p == 0)
+				throw std::bad_alloc();
+			if (n > cap)
+				memset(p + cap, 0, (n - cap) * sizeof(node*));
+			pos = p;
+			cap = n;
+		}
+	public:
+		storage() :
+				pos(0), cap(0), alloc(size_t(-1)) {
+		}
+		storage(size_t max_size) :
+				pos(static_cast<node **>(calloc(max_size, sizeof(node*)))), cap(
+						max_size), alloc(max_size) {
+			if (pos == 0 && max_size)
+				throw std::bad_alloc();
+		}
+		~storage() {
+			free(pos);
+		}
+		node &operator[](link x) {
+			return *x;
+		}
+		const node &operator[](link x) const {
+			return *x;
+		}
+		link find(id_type id) const {
+			return size_t(id) < cap ? pos[id] : 0;
+		}
+		void prefetch(id_type id) const {
+			if (size_t(id) < cap)
+				PH_PREFETCH(pos[id]);
+		}
+		template<typename F>
+		void for_each(F f) const {
+			for (size_t i = 0; i < cap; ++i)
+				if (const node *p = pos[i])
+					f(p->elem);
+		}
+		template<typename ... Args>
+		link create(id_type id, Args&&... args) {
+			if (size_t(id) >= cap)
+				grow(id);
+			node *p = node::make(alloc, id, std::forward<Args>(args)...);
+			pos[id] = p;
+			return p;
+		}
+		void destroy(link x) {
+			pos[x->elem.id] = 0;
+			x->~node();
+			alloc.deallocate(x);
+		}
+		// keeps the larger map and moves the entries of the smaller one into it.
+		void take_over(storage &other) {
+			alloc.take_over(other.alloc);
+			if (cap < other.cap) {
+				std::swap(pos, other.pos);
+				std::swap(cap, other.cap);
+			}
+			for (size_t i = 0; i < other.cap; ++i)
+				if (other.pos[i]) {
+					pos[i] = other.pos[i];
+					other.pos[i] = 0;
+				}
+		}
+		size_t memory_bytes() const {
+			return cap * sizeof(node*) + alloc.memory_bytes();
+		}
+		void reserve(size_t ids, size_t nodes) {
+			if (ids > cap)
+				resize(ids);
+			alloc.reserve(nodes);
+		}
+		void shrink_to_fit() {
+			size_t n = cap;
+			while (n && pos[n - 1] == 0)
+				--n;
+			if (n < cap)
+				resize(n);
+			alloc.shrink_to_fit();
+		}
+	};
+};
+
+/**
+ * All nodes live in one array indexed by id and the links are 32-bit indices into it.
+ * No separate map from the id's to the nodes is needed, and an int key takes 24 bytes per node instead of 40.
+ * The links are 64-bit indices for id's wider than 32 bits.
+ * NodeAlloc is not used.
+ * When the array grows, it is at least doubled and the elements are copied over,
+ * so references to elements and keys don't survive an insert with an uncovered id, reserve or shrink_to_fit.
+ * Since the links are indices, the array can be written out and read back (or mapped) as it is,
+ * which is what PairingHeap::save and load do. It provides write, read and attach for that.
+ */
+struct PH_IndexLayout {
+	template<typename Element, template<typename > class NodeAlloc>
+	class storage {
+	public:
+		typedef typename Element::id_type id_type;
+		// the node with id = i is at index i + 1, so that 0 stays the null link.
+		// The links are 32-bit unless the id's are wider.
+		typedef typename std::conditional<(sizeof(id_type) > 4), uint64_t,
+				uint32_t>::type link;
+		static const bool by_id = true;
+		static const bool by_index = true;
+		struct node {
+			link parent, left, right, son;
+			Element elem;
+			template<typename ... Args>
+			node(link self, id_type id, Args&&... args) :
+					parent(0), left(self), right(self), son(0), elem(id,
+							std::forward<Args>(args)...) {
+			}
+		};
+	private:
+		// the array of the nodes, covering the id's 0, 1, ..., cap-1. nodes[0] is never used.
+		// A slot is free iff its left link is 0, since the siblings list of a node is circular.
+		node *nodes;
+		size_t cap;
+		// whether the array is an image owned by the caller (see attach), which is never freed.
+		bool borrowed;
+
+		storage(const storage &);
+		storage &operator=(const storage &);
+
+		// calloc leaves the zeroing of the untouched pages to the system.
+		static node *allocate(size_t n) {
+			node *p = static_cast<node *>(calloc(n + 1, sizeof(node)));
+			if (p == 0)
+				throw std::bad_alloc();
+			return p;
+		}
+		// makes the array cover id. The links stay valid since they are indices.
+		void grow(id_type id) {
+			resize(std::max(size_t(id) + 1, 2 * cap));
+		}
+		// moves the nodes to an own array covering the id's 0, 1, ..., n-1, which has room for all nodes in use.
+		void resize(size_t n) {
+			node *p = allocate(n);
+			for (size_t i = 1; i <= cap; ++i)
+				if (nodes[i].left) {
+					new (p + i) node(std::move(nodes[i]));
+					nodes[i].~node();
+				}
+			replace(p, n, false);
+		}
+		// copies the nodes of other to the array p of the same size.
+		void copy_nodes(node *p, const storage &other, std::true_type) {
+			memcpy(p, other.nodes, (other.cap + 1) * sizeof(node));
+		}
+		void copy_nodes(node *p, const storage &other, std::false_type) {
+			size_t i = 1;
+			try {
+				for (; i <= other.cap; ++i)
+					if (other.nodes[i].left)
+						new (p + i) node(other.nodes[i]);
+			} catch (...) {
+				while (--i > 0)
+					if (p[i].left)
+						p[i].~node();
+				free(p);
+				throw;
+			}
+		}
+		// replaces the array by p of n + 1 nodes.
+		void replace(node *p, size_t n, bool borrow) {
+			if (!borrowed)
+				free(nodes);
+			nodes = p;
+			cap = n;
+			borrowed = borrow;
+		}
+	public:
+		storage() :
+				nodes(allocate(0)), cap(0), borrowed(false) {
+		}
+		storage(size_t max_size) :
+				nodes(allocate(max_size)), cap(max_size), borrowed(false) {
+		}
+		~storage() {
+			if (!borrowed)
+				free(nodes);
+		}
+		node &operator[](link x) {
+			return nodes[x];
+		}
+		const node &operator[](link x) const {
+			return nodes[x];
+		}
+		link find(id_type id) const {
+			return size_t(id) < cap && nodes[link(id) + 1].left ? link(id) + 1 : 0;
+		}
+		// the address is known without a load, and a free slot is harmless to prefetch.
+		void prefetch(id_type id) const {
+			if (size_t(id) < cap)
+				PH_PREFETCH(nodes + link(id) + 1);
+		}
+		// the nodes are visited in the order of the array.
+		template<typename F>
+		void for_each(F f) const {
+			const node *p = nodes;
+			for (size_t i = 1; i <= cap; ++i)
+				if (p[i].left)
+					f(p[i].elem);
+		}
+		template<typename ... Args>
+		link create(id_type id, Args&&... args) {
+			if (size_t(id) >= cap)
+				grow(id);
+			link x = link(id) + 1;
+			// the links are set before the element, so a throwing key must free the slot again.
+			try {
+				new (nodes + x) node(x, id, std::forward<Args>(args)...);
+			} catch (...) {
+				nodes[x].left = 0;
+				throw;
+			}
+			return x;
+		}
+		void destroy(link x) {
+			nodes[x].~node();
+			nodes[x].left = 0;
+		}
+		// keeps the larger array and moves the nodes of the smaller one into it.
+		void take_over(storage &other) {
+			if (cap < other.cap) {
+				std::swap(nodes, other.nodes);
+				std::swap(cap, other.cap);
+				std::swap(borrowed, other.borrowed);
+			}
+			for (size_t i = 1; i <= other.cap; ++i)
+				if (other.nodes[i].left) {
+					new (nodes + i) node(std::move(other.nodes[i]));
+					other.destroy(i);
+				}
+		}
+		// an attached image is counted, too.
+		size_t memory_bytes() const {
+			return (cap + 1) * sizeof(node);
+		}
+		// the nodes are the array, so only the id's matter.
+		void reserve(size_t ids, size_t) {
+			if (ids > cap)
+				resize(ids);
+		}
+		// an attached image is copied to an own array if it's too large.
+		void shrink_to_fit() {
+			size_t n = cap;
+			while (n && nodes[n].left == 0)
+				--n;
+			if (n < cap)
+				resize(n);
+		}
+		// trivially copyable nodes are copied with a single memcpy of the array, free slots included.
+		void copy(const storage &other) {
+			node *p = allocate(other.cap);
+			copy_nodes(p, other, std::is_trivially_copyable<node>());
+			replace(p, other.cap, false);
+		}
+		/**
+		 * The image of the array is the cap + 1 nodes as they are in memory, nodes[0] included,
+		 * so that the index of a node in it is its link. Only for trivially copyable elements.
+		 */
+		size_t capacity() const {
+			return cap;
+		}
+		void write(std::ostream &out) const {
+			out.write(reinterpret_cast<const char *>(nodes),
+					(cap + 1) * sizeof(node));
+		}
+		// replaces the array by the image of n + 1 nodes read from in. False if in fails.
+		// The array must have no nodes in use, since they aren't destroyed.
+		bool read(std::istream &in, size_t n) {
+			node *p = allocate(n);
+			if (!in.read(reinterpret_cast<char *>(p), (n + 1) * sizeof(node))) {
+				free(p);
+				return false;
+			}
+			replace(p, n, false);
+			return true;
+		}
+		// uses the image of n + 1 nodes at p in place. It stays owned by the caller, and is written to.
+		// The first insert with an uncovered id copies it to an own array. No nodes may be in use.
+		void attach(void *p, size_t n) {
+			replace(static_cast<node *>(p), n, true);
+		}
+	};
+};
+
+/**
+ * Like PH_PointerLayout, but the map from the id's to the nodes is a directory of pages
+ * which are only allocated when one of their id's is used.
+ * Meant for sparse id's: the space depends on the pages in use, not on the largest id.
+ */
+struct PH_PagedLayout {
+	template<typename Element, template<typename > class NodeAlloc>
+	class storage {
+	public:
+		typedef typename Element::id_type id_type;
+		typedef typename PH_PointerLayout::template storage<Element, NodeAlloc>::node node;
+		typedef node *link;
+		static const bool by_id = true;
+		static const bool by_index = false;
+	private:
+		static const int PAGE_BITS = 10;
+		static const size_t PAGE_SIZE = size_t(1) << PAGE_BITS;
+
+		// dir[i] is the page of the id's i*PAGE_SIZE, ..., (i+1)*PAGE_SIZE-1, or 0 if it's not allocated yet.
+		node ***dir;
+		size_t dirsz;
+		// where the nodes come from.
+		NodeAlloc<node> alloc;
+
+		storage(const storage &);
+		storage &operator=(const storage &);
+
+		// makes the directory cover the pages 0, 1, ..., n-1, and no more. The pages cut off must be free.
+		void resize(size_t n) {
+			if (n == 0) {
+				free(dir);
+				dir = 0;
+				dirsz = 0;
+				return;
+			}
+			node ***d = static_cast<node ***>(realloc(dir, n * sizeof(node**)));
+			if (d == 0)
+				throw std::bad_alloc();
+			if (n > dirsz)
+				memset(d + dirsz, 0, (n - dirsz) * sizeof(node**));
+			dir = d;
+			dirsz = n;
+		}
+		// returns the slot of the given id, allocating its page if needed.
+		node *&slot(id_type id) {
+			size_t page = size_t(id) >> PAGE_BITS;
+			if (page >= dirsz)
+				resize(std::max(page + 1, 2 * dirsz));
+			if (dir[page] == 0) {
+				dir[page] = static_cast<node **>(calloc(PAGE_SIZE, sizeof(node*)));
+				if (dir[page] == 0)
+					throw std::bad_alloc();
+			}
+			return dir[page][id & (PAGE_SIZE - 1)];
+		}
+	public:
+		storage() :
+				dir(0), dirsz(0), alloc(size_t(-1)) {
+		}
+		storage(size_t max_size) :
+				dir(0), dirsz((max_size + PAGE_SIZE - 1) >> PAGE_BITS), alloc(
+						max_size) {
+			dir = static_cast<node ***>(calloc(dirsz, sizeof(node**)));
+			if (dir == 0 && dirsz)
+				throw std::bad_alloc();
+		}
+		~storage() {
+			for (size_t i = 0; i < dirsz; ++i)
+				free(dir[i]);
+			free(dir);
+		}
+		node &operator[](link x) {
+			return *x;
+		}
+		const node &operator[](link x) const {
+			return *x;
+		}
+		link find(id_type id) const {
+			size_t page = size_t(id) >> PAGE_BITS;
+			return page < dirsz && dir[page] ?
+					dir[page][id & (PAGE_SIZE - 1)] : 0;
+		}
+		void prefetch(id_type id) const {
+			PH_PREFETCH(find(id));
+		}
+		// the pages never allocated are skipped.
+		template<typename F>
+		void for_each(F f) const {
+			for (size_t i = 0; i < dirsz; ++i)
+				if (dir[i])
+					for (size_t j = 0; j < PAGE_SIZE; ++j)
+						if (const node *p = dir[i][j])
+							f(p->elem);
+		}
+		template<typename ... Args>
+		link create(id_type id, Args&&... args) {
+			node *&s = slot(id);
+			s = node::make(alloc, id, std::forward<Args>(args)...);
+			return s;
+		}
+		void destroy(link x) {
+			id_type id = x->elem.id;
+			dir[size_t(id) >> PAGE_BITS][id & (PAGE_SIZE - 1)] = 0;
+			x->~node();
+			alloc.deallocate(x);
+		}
+		// keeps the larger directory and moves the pages of the smaller one into it.
+		// Only the pages used by both are merged entry by entry.
+		void take_over(storage &other) {
+			alloc.take_over(other.alloc);
+			if (dirsz < other.dirsz) {
+				std::swap(dir, other.dir);
+				std::swap(dirsz, other.dirsz);
+			}
+			for (size_t i = 0; i < other.dirsz; ++i) {
+				node **page = other.dir[i];
+				if (page == 0)
+					continue;
+				if (dir[i] == 0)
+					dir[i] = page;
+				else {
+					for (size_t j = 0; j < PAGE_SIZE; ++j)
+						if (page[j])
+							dir[i][j] = page[j];
+					free(page);
+				}
+				other.dir[i] = 0;
+			}
+		}
+		size_t memory_bytes() const {
+			size_t b = dirsz * sizeof(node**) + alloc.memory_bytes();
+			for (size_t i = 0; i < dirsz; ++i)
+				if (dir[i])
+					b += PAGE_SIZE * sizeof(node*);
+			return b;
+		}
+		// the pages are still allocated on first use.
+		void reserve(size_t ids, size_t nodes) {
+			size_t pages = (ids + PAGE_SIZE - 1) >> PAGE_BITS;
+			if (pages > dirsz)
+				resize(pages);
+			alloc.reserve(nodes);
+		}
+		// the pages without nodes are freed, too.
+		void shrink_to_fit() {
+			size_t n = 0;
+			for (size_t i = 0; i < dirsz; ++i) {
+				if (dir[i] == 0)
+					continue;
+				size_t j = 0;
+				while (j < PAGE_SIZE && dir[i][j] == 0)
+					++j;
+				if (j == PAGE_SIZE) {
+					free(dir[i]);
+					dir[i] = 0;
+				} else
+					n = i + 1;
+			}
+			if (n < dirsz)
+				resize(n);
+			alloc.shrink_to_fit();
+		}
+	};
+};
+
+/**
+ * Like PH_PointerLayout, but without any map from the id's to the nodes.
+ * The elements are only addressed by the handles returned by insert, so nothing is allocated for the id's
+ * and the id's needn't be unique or dense (e.g. 64-bit hashes with Id = uint64_t).
+ * contains is always false, and the operations taking an id throw an exception as if there were no such element.
+ */
+struct PH_HandleLayout {
+	template<typename Element, template<typename > class NodeAlloc>
+	class storage {
+	public:
+		typedef typename Element::id_type id_type;
+		typedef typename PH_PointerLayout::template storage<Element, NodeAlloc>::node node;
+		typedef node *link;
+		static const bool by_id = false;
+		static const bool by_index = false;
+	private:
+		// where the nodes come from.
+		NodeAlloc<node> alloc;
+
+		storage(const storage &);
+		storage &operator=(const storage &);
+	public:
+		storage() :
+				alloc(size_t(-1)) {
+		}
+		storage(size_t max_size) :
+				alloc(max_size) {
+		}
+		node &operator[](link x) {
+			return *x;
+		}
+		const node &operator[](link x) const {
+			return *x;
+		}
+		link find(id_type) const {
+			return 0;
+		}
+		void prefetch(id_type) const {
+		}
+		template<typename ... Args>
+		link create(id_type id, Args&&... args) {
+			return node::make(alloc, id, std::forward<Args>(args)...);
+		}
+		void destroy(link x) {
+			x->~node();
+			alloc.deallocate(x);
+		}
+		void take_over(storage &other) {
+			alloc.take_over(other.alloc);
+		}
+		size_t memory_bytes() const {
+			return alloc.memory_bytes();
+		}
+		void reserve(size_t, size_t nodes) {
+			alloc.reserve(nodes);
+		}
+		void shrink_to_fit() {
+			alloc.shrink_to_fit();
+		}
+	};
+};
+
+/**
+ * Variants of @PairingHeap.
+ * A variant provides:
+ * 		static const bool auxiliary:
+ * 			whether inserted and cut trees are collected in an auxiliary list instead of being merged with the root at once.
+ * 		typedef ... strategy:
+ * 			how a list of siblings is combined to a single tree; one of the variants below which are not auxiliary.
+ * 		static const bool prefetch:
+ * 			whether the nodes about to be visited are prefetched while the current ones are linked.
+ * 		static const bool incremental:
+ * 			whether the trees put into the auxiliary list are linked as they come, like the digits of a binary counter.
+ * The choice is made at compile time and costs nothing at run time.
+ */
+
+/**
+ * The standard two-pass pairing heap.
+ * The siblings are merged in pairs from left to right, then the pairs are merged from right to left.
+ */
+struct PH_TwoPass {
+	static const bool auxiliary = false;
+	static const bool prefetch = false;
+	static const bool incremental = false;
+	typedef PH_TwoPass strategy;
+};
+
+/**
+ * The front-to-back two-pass pairing heap.
+ * The siblings are merged in pairs from left to right, then the pairs are merged from left to right, too.
+ */
+struct PH_FrontToBack {
+	static const bool auxiliary = false;
+	static const bool prefetch = false;
+	static const bool incremental = false;
+	typedef PH_FrontToBack strategy;
+};
+
+/**
+ * The multipass pairing heap.
+ * The siblings are kept in a queue: the first two are merged and the result is put at the end,
+ * until one tree is left.
+ */
+struct PH_MultiPass {
+	static const bool auxiliary = false;
+	static const bool prefetch = false;
+	static const bool incremental = false;
+	typedef PH_MultiPass strategy;
+};
+
+/**
+ * The auxiliary variant of a strategy.
+ * Inserted and cut trees are put into an auxiliary list, which costs a couple of link writes.
+ * The list is combined with the strategy and merged with the root only when the minimum is needed.
+ */
+template<typename Strategy>
+struct PH_Auxiliary {
+	static const bool auxiliary = true;
+	static const bool prefetch = false;
+	static const bool incremental = false;
+	typedef Strategy strategy;
+};
+typedef PH_Auxiliary<PH_TwoPass> PH_AuxTwoPass;
+typedef PH_Auxiliary<PH_MultiPass> PH_AuxMultiPass;
+
+/**
+ * The incremental variant of a strategy: like PH_Auxiliary<Strategy>, but the auxiliary list is a binary counter.
+ * A tree put into it is linked with the tree of rank 0, the result with the tree of rank 1, and so on,
+ * until it takes a free rank. So an insert links once amortized and at most 63 times, and the list never holds
+ * more than 64 trees. The pairing which PH_Auxiliary leaves to the next find_min is spread over the inserts:
+ * after a streak of n inserts, delete_min combines O(logn) trees instead of n, which bounds its latency.
+ */
+template<typename Strategy>
+struct PH_Incremental {
+	static const bool auxiliary = true;
+	static const bool prefetch = false;
+	static const bool incremental = true;
+	typedef Strategy strategy;
+};
+
+/**
+ * The prefetching variant of another variant, e.g. PH_Prefetching<PH_TwoPass>.
+ * When combining, the next pair of siblings is prefetched while the current one is merged,
+ * and decrease_key prefetches the parent and the siblings of a node before it looks at them.
+ * It pays off for heaps much larger than the cache, and costs a few instructions otherwise.
+ */
+template<typename Variant>
+struct PH_Prefetching {
+	static const bool auxiliary = Variant::auxiliary;
+	static const bool prefetch = true;
+	static const bool incremental = Variant::incremental;
+	typedef typename Variant::strategy strategy;
+};
+
+/**
+ * Comparators for @PairingHeap.
+ * Any functor with bool operator()(const T&, const T&) will do. The following are treated specially.
+ *
+ * PH_IdTieBreak<Comparator> compares the keys with Comparator, and the elements with equal keys by their id's,
+ * the smaller id first. The order of the elements is total then, so they are deleted in the same order
+ * however they were inserted or changed, e.g. for replaying a simulation.
+ *
+ * For arithmetic keys with std::less or std::greater (or PH_IdTieBreak of them), the winner of a link
+ * is selected without a branch, which random keys would mispredict half of the time.
+ */
+template<typename Comparator>
+struct PH_IdTieBreak: Comparator {
+};
+
+// whether Comparator breaks ties by id.
+template<typename Comparator>
+struct PH_TieBreaks {
+	static const bool value = false;
+};
+template<typename Comparator>
+struct PH_TieBreaks<PH_IdTieBreak<Comparator> > {
+	static const bool value = true;
+};
+
+// whether keys of type T compare cheaply and without side effects with Comparator.
+template<typename T, typename Comparator>
+struct PH_Branchless {
+	static const bool value = false;
+};
+template<typename T>
+struct PH_Branchless<T, std::less<T> > {
+	static const bool value = std::is_arithmetic<T>::value;
+};
+template<typename T>
+struct PH_Branchless<T, std::greater<T> > {
+	static const bool value = std::is_arithmetic<T>::value;
+};
+template<typename T, typename Comparator>
+struct PH_Branchless<T, PH_IdTieBreak<Comparator> > {
+	static const bool value = PH_Branchless<T, Comparator>::value;
+};
+
+/**
+ * Statistics policies for @PairingHeap.
+ * A policy is notified of the events on the hot paths:
+ * 		void on_compare():
+ * 			the comparator is called.
+ * 		void on_link():
+ * 			a tree is made the child of another one.
+ * 		void begin_combine(), end_combine():
+ * 			a list of siblings is (has been) combined to a single tree.
+ * 		void on_decrease_key(bool cut):
+ * 			decrease_key changed a key in place (cut == false), or had to cut the subtree (cut == true).
+ * 		void on_increase_key(bool cut):
+ * 			increase_key changed the key of a leaf in place (cut == false), or had to cut the node (cut == true).
+ */
+
+/**
+ * Collects nothing. All its methods are empty and compile to nothing.
+ */
+struct PH_NoStats {
+	void on_compare() {
+	}
+	void on_link() {
+	}
+	void begin_combine() {
+	}
+	void end_combine() {
+	}
+	void on_decrease_key(bool) {
+	}
+	void on_increase_key(bool) {
+	}
+};
+
+/**
+ * Counts the events.
+ */
+struct PH_CountStats {
+	// the number of comparator calls.
+	unsigned long long comparisons;
+	// the number of links.
+	unsigned long long links;
+	// the number of combined lists of siblings, and their total and maximal length.
+	unsigned long long combines, combined_siblings, max_siblings;
+	// the number of decrease_key's that changed the key in place, and that cut the subtree.
+	unsigned long long decrease_key_in_place, decrease_key_cut;
+	// the number of increase_key's that changed the key in place, and that cut the node.
+	unsigned long long increase_key_in_place, increase_key_cut;
+private:
+	// the number of links when the current combining began.
+	unsigned long long links_before;
+public:
+	PH_CountStats() {
+		reset();
+	}
+	void reset() {
+		comparisons = links = 0;
+		combines = combined_siblings = max_siblings = 0;
+		decrease_key_in_place = decrease_key_cut = 0;
+		increase_key_in_place = increase_key_cut = 0;
+		links_before = 0;
+	}
+	/**
+	 * returns the average length of the combined lists of siblings.
+	 */
+	double average_siblings() const {
+		return combines ? double(combined_siblings) / combines : 0;
+	}
+	void on_compare() {
+		++comparisons;
+	}
+	void on_link() {
+		++links;
+	}
+	void begin_combine() {
+		links_before = links;
+	}
+	// combining n siblings always takes n - 1 links.
+	void end_combine() {
+		unsigned long long n = links - links_before + 1;
+		++combines;
+		combined_siblings += n;
+		max_siblings = std::max(max_siblings, n);
+	}
+	void on_decrease_key(bool cut) {
+		++(cut ? decrease_key_cut : decrease_key_in_place);
+	}
+	void on_increase_key(bool cut) {
+		++(cut ? increase_key_cut : increase_key_in_place);
+	}
+};
+
 /**
  * The class of pairing heaps.
  * A pairing heap is a rooted tree satisfying the heap property.
@@ -38,11 +1135,45 @@ public:
  * 			An element is a pair (id, key) where id can be used to identify an element.
  * 		typename Comparator = std::less<T>:
  * 			The functor used to compare two keys. The default results in a min-priority queue
+ * 			PH_IdTieBreak<Comparator> orders the elements with equal keys by id, for a deterministic order.
+ * 		template<typename> class NodeAlloc = PH_NewAlloc:
+ * 			The policy the nodes are allocated with.
+ * 			PH_NewAlloc uses the global new and delete for every node.
+ * 			PH_PoolAlloc keeps the nodes in slabs and recycles them through a free list.
+ * 		typename Layout = PH_PointerLayout:
+ * 			The policy the nodes are stored and linked with.
+ * 			PH_PointerLayout links the nodes from NodeAlloc with pointers.
+ * 			PH_IndexLayout keeps the nodes in one array indexed by id and links them with 32-bit (or 64-bit) indices.
+ * 			PH_PagedLayout is PH_PointerLayout with a paged map from the id's to the nodes, for sparse id's.
+ * 			PH_HandleLayout has no map at all, for the heaps whose elements are only addressed by handles.
+ * 		typename Variant = PH_TwoPass:
+ * 			The variant of pairing heaps.
+ * 			PH_TwoPass, PH_FrontToBack and PH_MultiPass differ in how the children of a deleted root are combined,
+ * 			and merge every inserted or cut tree with the root at once.
+ * 			PH_Auxiliary<Strategy> (e.g. PH_AuxTwoPass, PH_AuxMultiPass) collects these trees in an auxiliary list,
+ * 			which is only combined when find_min, delete_min or remove needs the minimum.
+ * 			PH_Incremental<Strategy> links the trees of that list as they come, so a delete_min after many inserts
+ * 			only combines O(logn) of them, for a shorter tail latency.
+ * 			PH_Prefetching<Variant> (e.g. PH_Prefetching<PH_TwoPass>) prefetches the nodes ahead while combining and in decrease_key.
+ * 		typename Stats = PH_NoStats:
+ * 			The statistics collected on the hot paths, see stats().
+ * 			PH_NoStats collects nothing and costs nothing.
+ * 			PH_CountStats counts comparisons, links, the lengths of the combined lists of siblings,
+ * 			and how often decrease_key has to cut.
+ * 		typename Id = int:
+ * 			The integral type of the id's. E.g. uint32_t allows 2^32-1 elements, and uint64_t more than that.
+ * 			The links of PH_IndexLayout are as wide as the id's, but never narrower than 32 bits.
  *
- * Constructor:
- * 		PairingHeap(int max_size)
- * 		A maximal size must be specified for allocating space for the addressability.
+ * Constructors:
+ * 		PairingHeap(size_t max_size)
+ * 		A maximal size is specified for allocating space for the addressability.
  * 		After creation, the valid id's are: 0, 1, ..., max_size-1
+ * 		PairingHeap()
+ * 		No maximal size is needed. All non-negative id's but the largest value of Id are valid,
+ * 		and the space for the addressability grows on demand in amortized O(1) time.
+ * 		PairingHeap(const PairingHeap &other), PairingHeap clone()
+ * 		A copy of other with the same trees, in O(n) time without any comparison.
+ * 		With PH_IndexLayout and trivially copyable keys, it's a single memcpy of the node array.
  *
  * Public methods:
  * 		size_t size():
@@ -51,197 +1182,881 @@ public:
  *		size_t max_size():
  *			determines whether there's an element in the pq with the given id.
  *			This won't throw any exceptions.
- *		bool contains(int id):
+ *		bool contains(Id id):
  *		const Element &find_min():
  * 			returns the current minimal element in the priority queue.
  * 			Throws an exception if the pq is empty.
- *		const T& get_key(int id):
+ *		OutIt peek_k(size_t k, OutIt out):
+ *			writes the k smallest elements to out in sorted order, without changing the pq.
+ *			With an auxiliary variant, both consolidate the trees, so unlike other const methods
+ *			they mustn't run in several threads at the same time, even on a const pq.
+ *		void for_each(F fn):
+ *			calls fn(elem) for every element, in no particular order.
+ *		const T& get_key(Id id):
  *			returns the current key of the element with the given id.
  *			Throws an exception if the id is invalid or there's no element with that id.
- *		void insert(int id, const T& key):
- *			try to insert an element with the given id and key.
+ *		Handle insert(Id id, const T& key), Handle insert(Id id, T&& key):
+ *			try to insert an element with the given id and key, and return a handle to it.
  *			Throws an exception if the id is invalid or there's already an element with that id.
+ *		Handle emplace(Id id, Args&&... args):
+ *			like insert, but the key is constructed in place from args.
+ *		void insert_bulk(It first, It last):
+ *			inserts all elements in the range of (id, key) pairs.
+ *			Throws an exception if some id is invalid or used twice, and then no element is inserted.
  *		Element delete_min():
- *			removes and returns the current minimum in the pq.
+ *			removes and returns the current minimum in the pq. The element is moved out of the heap.
  * 			Throws an exception if the pq is empty.
- * 		Element remove(int id):
- *			removes and returns the element with the given id.
+ *		OutIt extract_k(size_t k, OutIt out), OutIt drain_sorted(OutIt out):
+ *			remove the k smallest (all) elements and write them to out in sorted order.
+ *			drain_sorted sorts the elements in a buffer of n elements instead of combining the tree n times.
+ *		OutIt extract_until(const T& bound, OutIt out):
+ *			removes the elements whose key isn't larger than bound and writes them to out in sorted order
+ *			(e.g. the expired timers), consolidating the auxiliary list only once.
+ * 		Element remove(Id id):
+ *			removes and returns the element with the given id. The element is moved out of the heap.
  *	  		Throws an exception if the id is invalid or there's no element with that id.
- *		void decrease_key(int id, const T& newkey):
+ *		void decrease_key(Id id, const T& newkey), void decrease_key(Id id, T&& newkey):
  *			try to decrease the key of the element with the given id.
  * 			Throws an exception if the id is invalid or there's no element with that id.
  * 			It does nothing if newkey is larger than the current key of the element.
  * 			If the new key is as small as the root, that node will be the made the new root, even if its current key equals to the new one.
+ * 			(With PH_IdTieBreak, only if its id is smaller, too.)
+ *		void decrease_key_batch(It first, It last):
+ *			decreases the keys of all elements in the range of (id, newkey) pairs, merging the cut subtrees with the root only once.
+ * 			Throws an exception if some id is invalid or there's no element with that id, and then no key is changed.
+ *		void increase_key(Id id, const T& newkey), void increase_key(Id id, T&& newkey):
+ *			try to increase the key of the element with the given id.
+ * 			Throws an exception if the id is invalid or there's no element with that id.
+ * 			It does nothing if newkey is smaller than the current key of the element.
+ *		void update_key(Id id, const T& newkey), void update_key(Id id, T&& newkey):
+ *			changes the key of the element with the given id to newkey, whether it's smaller or larger.
+ * 			Throws an exception if the id is invalid or there's no element with that id.
+ *		void prefetch(Id id):
+ *			a hint that the element with the given id will be changed soon, e.g. some edges ahead in Dijkstra's algorithm.
+ *			It starts to load its node into the cache, with any variant. It does nothing for an invalid or unused id.
+ *		bool try_insert(Id id, const T& key), bool try_delete_min(Element &min):
+ *			like insert and delete_min, but return false instead of throwing an exception.
+ *		get_key_unchecked, insert_unchecked, emplace_unchecked, delete_min_unchecked, remove_unchecked,
+ *		decrease_key_unchecked, increase_key_unchecked, update_key_unchecked:
+ *			like the operations without the suffix, but without any checks, which are only asserted in debug builds.
+ *		get(Handle h), get_key, remove, decrease_key, increase_key, update_key, prefetch:
+ *			the operations on the element a handle refers to, without looking up its id (e.g. with PH_HandleLayout).
+ *		Handle handle(Id id):
+ *			returns a handle to the element with the given id.
+ * 			Throws an exception if the id is invalid or there's no element with that id.
+ *		const Stats &stats():
+ *			returns the statistics collected so far; see the Stats template parameter.
+ *		void clear():
+ *			removes all elements, keeping the allocated space for reuse.
+ *		size_t memory_bytes():
+ *			returns the number of bytes held by the pq, including the map from the id's and the nodes.
+ *		void reserve(size_t n), void shrink_to_fit():
+ *			make room for n elements in total, and give back the space not needed by the current elements.
+ *		void meld(PairingHeap &other):
+ *			moves all elements of other into this pq, leaving other empty.
+ *			No id may be used in both heaps.
+ *		void save(std::ostream &out), void load(std::istream &in), void load(void *image, size_t bytes):
+ *			write a binary snapshot of the pq, and replace its elements by one. Only for PH_IndexLayout.
+ *			The second load uses a snapshot in memory (e.g. a mapped file) in place, without copying it.
+ * 			Load throws an exception if the header isn't one of a snapshot of this type of heap, or if the image is short.
+ * 			Only the header is checked: the nodes are trusted, and corrupt links give undefined behavior.
  * Time:
  * 		Delete_min takes O(logn) amortized time.
  * 		Decrease_key is shown to run in O(loglogn) <= T <= O(logn) amortized time.
+ * 		Increase_key takes O(logn) amortized time, like remove, unless the node is a leaf.
+ * 		Meld links the roots in constant time. Taking over the id's of the other heap costs
+ * 			O(number of pages) with PH_PagedLayout, and O(smaller id map) with the other layouts.
+ * 		Clear takes O(n) time, and insert_bulk takes O(k) time for k elements.
  * 		All other methods take constant amortized time.
  */
-template<typename T, typename Comparator = std::less<T> >
+template<typename T, typename Comparator = std::less<T>,
+		template<typename > class NodeAlloc = PH_NewAlloc,
+		typename Layout = PH_PointerLayout, typename Variant = PH_TwoPass,
+		typename Stats = PH_NoStats, typename Id = int>
 class PairingHeap {
+	static_assert(std::is_integral<Id>::value, "the id's must be integers");
 
 	/**
 	 * The representation of an element: a pair (id, key).
 	 * Every element has a unique id.
 	 */
 	struct Element {
-		int id;
+		typedef Id id_type;
+		Id id;
 		T key;
-		Element(int id, T key) :
-				id(id), key(key) {
+		template<typename ... Args>
+		Element(Id id, Args&&... args) :
+				id(id), key(std::forward<Args>(args)...) {
+		}
+		Element() :
+				id(Id(-1)), key() {
 		}
 	};
 	/**
-	 * The internal structure of a node in the heap.
-	 * Each node maintains 4 pointers:
-	 * 		the parent (0 if the current node is the root)
-	 * 		one of the children (0 if none)
-	 * 		the left and right siblings. The list of siblings is circular.
-	 *
+	 * The internal structure of a node in the heap is given by the layout.
+	 * Each node maintains 4 links:
+	 * 		the parent (0 if the current node is the root)
+	 * 		one of the children (0 if none)
+	 * 		the left and right siblings. The list of siblings is circular.
+	 *
+	 */
+	typedef typename Layout::template storage<Element, NodeAlloc> Storage;
+	typedef typename Storage::node PHNode;
+	typedef typename Storage::link link;
+
+	// the current and maximal size. The valid id's are in [0, maxsz).
+	size_t sz, maxsz;
+	// the comparator functor
+	Comparator less;
+	// The following are mutable since find_min and peek_k are logically const: with an auxiliary variant
+	// they consolidate the trees first, which changes the links and the statistics, but not the elements.
+	// the statistics of the hot paths.
+	mutable Stats st;
+	// the nodes, and the map from the id's to them.
+	mutable Storage store;
+	// the link to the root.
+	mutable link root;
+	// the circular list of trees not merged with the root yet. Always 0 unless Variant::auxiliary.
+	mutable link aux;
+	// counter[r] is the tree of rank r in the auxiliary list, or 0. Only used if Variant::incremental.
+	// The ranks below nranks may be in use.
+	static const size_t RANKS = 64;
+	mutable link counter[Variant::incremental ? RANKS : 1];
+	mutable size_t nranks;
+
+	// the possible exceptions. (initialized below out of the class)
+	static const PH_Exception PH_EX_EMPTY, PH_EX_BAD_ID, PH_EX_ALREADY_EXISTS,
+			PH_EX_NO_SUCH_ELEMENT, PH_EX_BAD_IMAGE;
+
+	/**
+	 * The header of a snapshot written by save. The image of the nodes follows it.
+	 * It takes 64 bytes, so that the nodes in a mapped file are aligned.
+	 */
+	struct Image {
+		char magic[8];
+		uint32_t version, node_size, key_size, auxiliary;
+		uint64_t capacity, size, max_size;
+		uint64_t root, aux;
+	};
+
+	// the header of a snapshot of this pq.
+	Image header() const {
+		static_assert(std::is_trivially_copyable<T>::value,
+				"snapshots need trivially copyable keys");
+		static_assert(sizeof(Image) == 64 && 64 % alignof(PHNode) == 0,
+				"the nodes after the header must be aligned");
+		Image h;
+		memset(&h, 0, sizeof h);
+		memcpy(h.magic, "PHIMAGE", 8);
+		h.version = 1;
+		h.node_size = sizeof(PHNode);
+		h.key_size = sizeof(T);
+		h.auxiliary = Variant::auxiliary;
+		h.capacity = store.capacity();
+		h.size = sz;
+		h.max_size = maxsz;
+		h.root = root;
+		h.aux = aux;
+		return h;
+	}
+	// determines whether h is the header of a snapshot of this type of heap. The nodes aren't checked.
+	bool valid(const Image &h) const {
+		Image own = header();
+		return memcmp(h.magic, own.magic, 8) == 0 && h.version == own.version
+				&& h.node_size == own.node_size && h.key_size == own.key_size
+				&& h.auxiliary == own.auxiliary && h.max_size <= max_ids()
+				&& h.capacity <= h.max_size && h.size <= h.capacity
+				&& h.root <= h.capacity && h.aux <= h.capacity
+				&& (h.size == 0) == (h.root == 0 && h.aux == 0);
+	}
+	/**
+	 * takes the state of the pq from the header of a snapshot whose nodes are in place.
+	 * The counter of an incremental variant isn't saved, so the auxiliary trees are put into it again.
+	 */
+	void restore(const Image &h) {
+		sz = size_t(h.size);
+		maxsz = size_t(h.max_size);
+		root = link(h.root);
+		aux = 0;
+		reset_counter();
+		if (h.aux)
+			defer(link(h.aux));
+	}
+
+	// the node x refers to.
+	PHNode &node(link x) {
+		return store[x];
+	}
+	const PHNode &node(link x) const {
+		return store[x];
+	}
+	// starts to load the node x into the cache, if the variant prefetches and x isn't 0.
+	void ahead(link x) const {
+		if (Variant::prefetch && x)
+			PH_PREFETCH(&store[x]);
+	}
+
+	// compares two keys with the comparator.
+	bool less_key(const T &a, const T &b) {
+		st.on_compare();
+		return less(a, b);
+	}
+	// compares two elements: by their keys, and by their id's if the comparator breaks ties.
+	bool less_elem(const Element &a, const Element &b) {
+		if (!PH_TieBreaks<Comparator>::value)
+			return less_key(a.key, b.key);
+		st.on_compare();
+		if (PH_Branchless<T, Comparator>::value)
+			return less(a.key, b.key) | (!less(b.key, a.key) & (a.id < b.id));
+		return less(a.key, b.key) || (!less(b.key, a.key) && a.id < b.id);
+	}
+
+	// the number of id's that an Id can hold, which is the default maximal size.
+	static size_t max_ids() {
+		return size_t(std::numeric_limits<Id>::max());
+	}
+	// determines whether id is in [0, maxsz).
+	bool valid_id(Id id) const {
+		return !negative(id, std::is_signed<Id>())
+				&& typename std::make_unsigned<Id>::type(id) < maxsz;
+	}
+	static bool negative(Id id, std::true_type) {
+		return id < 0;
+	}
+	static bool negative(Id, std::false_type) {
+		return false;
+	}
+	// ensures id is valid and there's NO element with this id.
+	void ensure_not_existing(Id id) const {
+		if (!valid_id(id))
+			throw PH_EX_BAD_ID;
+		if (store.find(id))
+			throw PH_EX_ALREADY_EXISTS;
+	}
+	// ensures id is valid and there's ONE element with this id.
+	void ensure_existing(Id id) const {
+		if (!valid_id(id))
+			throw PH_EX_BAD_ID;
+		if (store.find(id) == 0)
+			throw PH_EX_NO_SUCH_ELEMENT;
+	}
+	// ensures the heap is non-empty
+	void ensure_nonempty() const {
+		if (sz == 0)
+			throw PH_EX_EMPTY;
+	}
+
+	/**
+	 * Merges nodes x and y.
+	 * They must not have parent or siblings.
+	 * Returns the resulting root.
+	 * If nodes x and y have the same key, x will be the result (unless the comparator breaks ties by id).
+	 */
+	link merge(link x, link y) {
+		bool flip = less_elem(node(y).elem, node(x).elem);
+		if (PH_Branchless<T, Comparator>::value) {
+			// the winner is loaded by index, so there's no branch to mispredict.
+			link xy[2] = { x, y };
+			x = xy[flip];
+			y = xy[!flip];
+		} else if (flip)
+			std::swap(x, y);
+		st.on_link();
+		PHNode &nx = node(x), &ny = node(y);
+		ny.parent = x;
+		link xson = nx.son;
+		if (xson == 0) {
+			nx.son = y;
+		} else {
+			PHNode &ns = node(xson);
+			ny.left = ns.left;
+			node(ns.left).right = y;
+			ny.right = xson;
+			ns.left = y;
+			nx.son = y;
+		}
+		return x;
+	}
+
+	/**
+	 * concatenates the circular lists of siblings a and b, either of which may be 0.
+	 * Returns the resulting list.
+	 */
+	link splice(link a, link b) {
+		if (a == 0)
+			return b;
+		if (b == 0)
+			return a;
+		link atail = node(a).left, btail = node(b).left;
+		node(atail).right = b;
+		node(b).left = atail;
+		node(btail).right = a;
+		node(a).left = btail;
+		return a;
+	}
+	/**
+	 * combines the auxiliary list and merges the result with the root.
+	 * If some tree in the list has the same key as the root, that tree will be the root.
+	 */
+	void consolidate() {
+		if (aux) {
+			link x = combine_siblings(aux);
+			aux = 0;
+			reset_counter();
+			root = root ? merge(x, root) : x;
+		}
+	}
+	/**
+	 * puts the trees of the list x into the auxiliary list.
+	 * If the variant is incremental, each one is linked with the trees of the counter.
+	 */
+	void defer(link x) {
+		if (!Variant::incremental) {
+			aux = splice(aux, x);
+			return;
+		}
+		link p = x;
+		do {
+			link next = node(p).right;
+			isolate(p);
+			carry(p);
+			p = next;
+		} while (p != x);
+	}
+	/**
+	 * adds the tree t to the counter: as long as there's a tree of the same rank, take it out and link it with t,
+	 * which goes up a rank. The highest rank takes any number of trees.
+	 * The new tree wins a tie.
+	 */
+	void carry(link t) {
+		size_t r = 0;
+		while (counter[r]) {
+			link y = counter[r];
+			counter[r] = 0;
+			unlink_aux(y);
+			t = merge(t, y);
+			if (r + 1 < RANKS)
+				++r;
+		}
+		counter[r] = t;
+		nranks = std::max(nranks, r + 1);
+		aux = splice(aux, t);
+	}
+	// takes the tree y out of the auxiliary list.
+	void unlink_aux(link y) {
+		PHNode &ny = node(y);
+		if (aux == y)
+			aux = ny.right == y ? 0 : ny.right;
+		node(ny.left).right = ny.right;
+		node(ny.right).left = ny.left;
+		isolate(y);
+	}
+	// the tree x leaves the auxiliary list, so it mustn't be in the counter any more.
+	void unrank(link x) {
+		for (size_t r = 0; r < nranks; ++r)
+			if (counter[r] == x) {
+				counter[r] = 0;
+				return;
+			}
+	}
+	// empties the counter, e.g. when the auxiliary list is emptied.
+	void reset_counter() {
+		if (Variant::incremental) {
+			std::fill(counter, counter + nranks, link(0));
+			nranks = 0;
+		}
+	}
+	/**
+	 * removes the node p and returns its element.
+	 * Algo:
+	 * 		1. Cut the node from the heap.
+	 *		2. Combine its children and merge the result with the root (or put it into the auxiliary list).
+	 */
+	Element remove_node(link p) {
+		// the root is removed without consolidation, as it may be not the minimum in the auxiliary mode.
+		if (p == root)
+			return pop_root();
+		cut(p);
+		Element r(std::move(node(p).elem));
+		link pson = node(p).son;
+		store.destroy(p);
+		--sz;
+		pson = combine_siblings(pson);
+		if (pson) {
+			if (Variant::auxiliary)
+				defer(pson);
+			else
+				root = merge(root, pson);
+		}
+		return r;
+	}
+	/**
+	 * removes and returns the root, and combines its children to get the new root.
+	 */
+	Element pop_root() {
+		Element r(std::move(node(root).elem));
+		link rson = node(root).son;
+		store.destroy(root);
+		--sz;
+		root = combine_siblings(rson);
+		return r;
+	}
+	/**
+	 * detaches the subtree of x, which isn't the root, from its parent (or from the auxiliary list).
+	 * Afterwards x has no parent or siblings.
+	 */
+	void cut(link x) {
+		PHNode &nx = node(x);
+		if (nx.parent) {
+			PHNode &np = node(nx.parent);
+			// if its parent points to this node, point to another sibling (if any).
+			if (np.son == x)
+				np.son = nx.right == x ? 0 : nx.right;
+		} else {
+			if (aux == x)
+				aux = nx.right == x ? 0 : nx.right;
+			if (Variant::incremental)
+				unrank(x);
+		}
+		node(nx.left).right = nx.right;
+		node(nx.right).left = nx.left;
+		isolate(x);
+	}
+	/**
+	 * decreases the key of node x to newkey, if it's not larger than the current key.
+	 * Returns x if its subtree had to be cut from the heap, which the caller has to put back, and 0 otherwise.
 	 */
-	struct PHNode {
-		Element elem;
-		PHNode *parent, *left, *right, *son;
-		PHNode(Element elem) :
-				elem(elem), parent(0), left(this), right(this), son(0) {
+	template<typename K>
+	link lower(link x, K &&newkey) {
+		if (Variant::prefetch) {
+			// cut needs them, and they are known before the key is compared.
+			const PHNode &nx = node(x);
+			ahead(nx.parent);
+			ahead(nx.left);
+			ahead(nx.right);
 		}
-	};
-
-	// the current and maximal size.
-	int sz, maxsz;
-	// the comparator functor
-	Comparator less;
-	// pos[i] is the address of the node with element with id = i.
-	PHNode **pos;
-	// the pointer to the root.
-	PHNode *root;
-
-	// the possible exceptions. (initialized below out of the class)
-	static const PH_Exception PH_EX_EMPTY, PH_EX_BAD_ID, PH_EX_ALREADY_EXISTS,
-			PH_EX_NO_SUCH_ELEMENT;
-
-	// ensures id is valid and there's NO element with this id.
-	void ensure_not_existing(int id) const {
-		if (id < 0 || id >= maxsz)
-			throw PH_EX_BAD_ID;
-		if (pos[id])
-			throw PH_EX_ALREADY_EXISTS;
+		if (less_key(node(x).elem.key, newkey))
+			return 0;
+		// if the node is the root or has no parent (in the auxiliary list or in a batch), we're happy.
+		bool in_place = x == root || node(x).parent == 0;
+		st.on_decrease_key(!in_place);
+		if (!in_place)
+			cut(x);
+		node(x).elem.key = std::forward<K>(newkey);
+		return in_place ? 0 : x;
 	}
-	// ensures id is valid and there's ONE element with this id.
-	void ensure_existing(int id) const {
-		if (id < 0 || id >= maxsz)
-			throw PH_EX_BAD_ID;
-		if (pos[id] == 0)
-			throw PH_EX_NO_SUCH_ELEMENT;
+	/**
+	 * decreases the key of node x to newkey, if it's not larger than the current key.
+	 * Algo:
+	 * 		cut the node from the heap and then merge the subtree with the root
+	 * 		(or put it into the auxiliary list).
+	 */
+	template<typename K>
+	void decrease(link x, K &&newkey) {
+		if (lower(x, std::forward<K>(newkey)))
+			put_back(x);
 	}
-	// ensures the heap is non-empty
-	void ensure_nonempty() const {
-		if (sz == 0)
-			throw PH_EX_EMPTY;
+	/**
+	 * merges the tree x, which has no parent, with the root (or puts it into the auxiliary list).
+	 * x may also be a list of such trees in the auxiliary mode.
+	 */
+	void put_back(link x) {
+		// this ordering of the arguments makes sure that if they have the same key, the new node will be the root.
+		// the consolidation keeps this ordering for the trees in the auxiliary list.
+		if (Variant::auxiliary)
+			defer(x);
+		else
+			root = root ? merge(x, root) : x;
 	}
-
 	/**
-	 * Merges nodes x and y.
-	 * They must not have parent or siblings.
-	 * Returns the resulting root.
-	 * If nodes x and y have the same key, x will be the result.
+	 * increases the key of node x to newkey, if it's not smaller than the current key.
+	 * Algo:
+	 * 		if x is a leaf, the heap property still holds. We're happy.
+	 * 		Otherwise detach x from the heap, combine its children and merge both x and the result with the root
+	 * 		(or put them into the auxiliary list). The node is reused.
 	 */
-	PHNode *merge(PHNode *x, PHNode *y) {
-		if (less(y->elem.key, x->elem.key))
-			std::swap(x, y);
-		y->parent = x;
-		PHNode *xson = x->son;
-		if (xson == 0) {
-			x->son = y;
+	template<typename K>
+	void increase(link x, K &&newkey) {
+		if (less_key(newkey, node(x).elem.key))
+			return;
+		link xson = node(x).son;
+		st.on_increase_key(xson != 0);
+		node(x).elem.key = std::forward<K>(newkey);
+		if (xson == 0)
+			return;
+		if (x == root)
+			root = 0;
+		else
+			cut(x);
+		node(x).son = 0;
+		xson = combine_siblings(xson);
+		if (Variant::auxiliary) {
+			defer(xson);
+			defer(x);
 		} else {
-			y->left = xson->left;
-			xson->left->right = y;
-			y->right = xson;
-			xson->left = y;
-			x->son = y;
+			// the children go first: if they have the same key, x won't be the root.
+			root = root ? merge(root, xson) : xson;
+			root = merge(root, x);
 		}
-		return x;
 	}
-
 	/**
-	 * appends element b to the list ending at a. (using pointers left and right as a linked list)
+	 * changes the key of node x to newkey in either direction.
+	 */
+	template<typename K>
+	void update(link x, K &&newkey) {
+		if (less_key(node(x).elem.key, newkey))
+			increase(x, std::forward<K>(newkey));
+		else
+			decrease(x, std::forward<K>(newkey));
+	}
+	/**
+	 * appends element b to the list ending at a. (using links left and right as a linked list)
 	 * Returns the new end of the list. If a is 0, return b itself.
 	 */
-	PHNode *append(PHNode *a, PHNode *b) {
+	link append(link a, link b) {
 		if (a == 0)
 			return b;
-		a->right = b;
-		b->left = a;
+		node(a).right = b;
+		node(b).left = a;
 		return b;
 	}
+	// makes x a single node list without parent.
+	void isolate(link x) {
+		PHNode &nx = node(x);
+		nx.parent = 0;
+		nx.left = nx.right = x;
+	}
 	/**
-	 * combines the siblings of x to get a single root.
+	 * combines the siblings of x to get a single root, with the strategy of the variant.
 	 * Returns the resulting root.
-	 * Algo:
-	 *		1. First merge the nodes in pairs (thus "pairing heaps") from left to right
-	 *		2. Then merge the resulting list of heaps from right to left.
 	 */
-	PHNode *combine_siblings(PHNode *x) {
+	link combine_siblings(link x) {
 		if (x == 0)
 			return 0;
-		PHNode *p = x, *end = 0;
-		do { // the forward merging
-			PHNode *n1 = p, *n2 = p->right;
-			n1->parent = 0;
-			n1->left = n1->right = n1;
+		st.begin_combine();
+		x = combine(x, typename Variant::strategy());
+		st.end_combine();
+		return x;
+	}
+	/**
+	 * merges the siblings of x in pairs (thus "pairing heaps") from left to right.
+	 * Returns the last resulting heap, and the first one in first.
+	 * The resulting heaps are linked from left to right by their right links,
+	 * and from right to left by their left links. The left link of the first one is 0.
+	 */
+	link pair_siblings(link x, link &first) {
+		link p = x, end = 0;
+		first = 0;
+		do {
+			link n1 = p, n2 = node(p).right;
+			isolate(n1);
 			if (n2 == x) {
-				n1->left = 0;
+				node(n1).left = 0;
 				end = append(end, n1);
 				break;
 			}
-			p = n2->right;
-			n2->parent = 0;
-			n2->left = n2->right = n2;
+			p = node(n2).right;
+			// the next pair starts to load while this one is merged.
+			ahead(p);
+			isolate(n2);
 			n1 = merge(n1, n2);
-			n1->left = 0;
+			node(n1).left = 0;
 			end = append(end, n1);
+			if (first == 0)
+				first = n1;
 		} while (p != x);
-
-		PHNode *res = end;
-		p = end->left;
-		res->left = res->right = res;
+		if (first == 0)
+			first = end;
+		return end;
+	}
+	/**
+	 * Algo:
+	 *		1. First merge the nodes in pairs from left to right
+	 *		2. Then merge the resulting list of heaps from right to left.
+	 */
+	link combine(link x, PH_TwoPass) {
+		link first, end = pair_siblings(x, first);
+		link res = end, p = node(end).left;
+		node(res).left = node(res).right = res;
 		while (p) { //backwards
-			PHNode *p2 = p->left;
-			p->left = p->right = p;
+			link p2 = node(p).left;
+			ahead(p2);
+			node(p).left = node(p).right = p;
 			res = merge(res, p);
 			p = p2;
 		}
 		return res;
 	}
 	/**
-	 * disposes the entire heap recursively.
-	 * TODO: eliminate recursion.
+	 * Algo:
+	 *		1. First merge the nodes in pairs from left to right
+	 *		2. Then merge the resulting list of heaps from left to right, too.
 	 */
-	void recursively_destruct(PHNode *x) {
-		PHNode *xson = x->son;
-		if (xson == 0) // the heap has only a root.
-			delete x;
-		else {
-			PHNode *p = xson;
-			do {
-				PHNode *p2 = p->right;
-				recursively_destruct(p);
-				p = p2;
-			} while (p != xson);
-			delete x;
+	link combine(link x, PH_FrontToBack) {
+		link p, end = pair_siblings(x, p);
+		link res = 0;
+		for (;;) {
+			link p2 = node(p).right;
+			ahead(p2);
+			node(p).left = node(p).right = p;
+			res = res ? merge(res, p) : p;
+			if (p == end)
+				break;
+			p = p2;
+		}
+		return res;
+	}
+	/**
+	 * Algo:
+	 * 		Use the circular list of siblings as a queue.
+	 * 		Repeatedly merge the first two heaps and put the result at the end, until there's one heap left.
+	 */
+	link combine(link x, PH_MultiPass) {
+		while (node(x).right != x) {
+			link a = x, b = node(a).right, rest = node(b).right;
+			if (rest == a) { // only a and b are left.
+				isolate(a);
+				isolate(b);
+				return merge(a, b);
+			}
+			link tail = node(a).left;
+			ahead(rest);
+			isolate(a);
+			isolate(b);
+			link m = merge(a, b);
+			node(m).left = tail;
+			node(m).right = rest;
+			node(tail).right = m;
+			node(rest).left = m;
+			x = rest;
+		}
+		isolate(x);
+		return x;
+	}
+	// calls fn(elem) for every element, through the id map of the layout.
+	template<typename F>
+	void visit(F &fn, std::true_type) const {
+		store.for_each(fn);
+	}
+	// calls fn(elem) for every element, walking the trees, for the layouts without an id map.
+	template<typename F>
+	void visit(F &fn, std::false_type) const {
+		std::vector<link> stack;
+		if (root)
+			stack.push_back(root);
+		if (aux)
+			for (link p = aux; stack.push_back(p), node(p).right != aux;)
+				p = node(p).right;
+		while (!stack.empty()) {
+			link x = stack.back();
+			stack.pop_back();
+			fn(const_cast<const Element &>(node(x).elem));
+			if (link c = node(x).son)
+				do {
+					stack.push_back(c);
+					c = node(c).right;
+				} while (c != node(x).son);
+		}
+	}
+	/**
+	 * pushes x and its siblings onto the given stack, chained through the parent links.
+	 * Returns the new top of the stack.
+	 */
+	link push_siblings(link x, link stack) {
+		link p = x;
+		do {
+			link p2 = node(p).right;
+			node(p).parent = stack;
+			stack = p;
+			p = p2;
+		} while (p != x);
+		return stack;
+	}
+	/**
+	 * disposes the entire heaps rooted at x and its siblings.
+	 * If sink isn't 0, the elements are moved to it first.
+	 * Algo:
+	 * 		keep a stack of the nodes still to be disposed, chained through their parent links.
+	 * 		Pop a node, push all its children and dispose it. No recursion is needed.
+	 */
+	void destruct(link x, std::vector<Element> *sink = 0) {
+		x = push_siblings(x, 0);
+		while (x) {
+			PHNode &nx = node(x);
+			link next = nx.parent;
+			if (nx.son)
+				next = push_siblings(nx.son, next);
+			if (sink)
+				sink->push_back(std::move(nx.elem));
+			store.destroy(x);
+			x = next;
+		}
+	}
+	/**
+	 * copies x and its siblings of other in the same order into the empty list, as children of parent (or roots if it's 0).
+	 * Every copy joins the list at once, so that clear disposes it if a later one fails.
+	 * The pairs of originals and copies are pushed to todo, for copying their children.
+	 */
+	void copy_siblings(const PairingHeap &other, link x, link parent,
+			link &list, std::vector<std::pair<link, link> > &todo) {
+		link p = x;
+		do {
+			const PHNode &np = other.node(p);
+			link c = store.create(np.elem.id, np.elem.key);
+			node(c).parent = parent;
+			list = splice(list, c);
+			todo.push_back(std::make_pair(p, c));
+			p = np.right;
+		} while (p != x);
+	}
+	// ranks the copies of the auxiliary trees of other, which are in todo from first on, like their originals.
+	void copy_counter(const PairingHeap &other, size_t first,
+			const std::vector<std::pair<link, link> > &todo) {
+		for (size_t r = 0; r < other.nranks; ++r)
+			for (size_t i = first; i < todo.size() && other.counter[r]; ++i)
+				if (todo[i].first == other.counter[r]) {
+					counter[r] = todo[i].second;
+					break;
+				}
+		nranks = other.nranks;
+	}
+	// copies the trees of other, which have the same links in the copied array, and so does the counter.
+	void copy_trees(const PairingHeap &other, std::true_type) {
+		store.copy(other.store);
+		root = other.root;
+		aux = other.aux;
+		std::copy(other.counter, other.counter + other.nranks, counter);
+		nranks = other.nranks;
+	}
+	/**
+	 * copies the trees of other node by node, with the same shape.
+	 * Algo:
+	 * 		copy the roots, then the children of every copied node, with a stack of the nodes to visit.
+	 * 		The new nodes come from one slab of PH_PoolAlloc, which is reserved first.
+	 */
+	void copy_trees(const PairingHeap &other, std::false_type) {
+		store.reserve(0, other.sz);
+		std::vector<std::pair<link, link> > todo;
+		try {
+			if (other.root)
+				copy_siblings(other, other.root, 0, root, todo);
+			if (other.aux) {
+				size_t first = todo.size();
+				copy_siblings(other, other.aux, 0, aux, todo);
+				copy_counter(other, first, todo);
+			}
+			while (!todo.empty()) {
+				std::pair<link, link> t = todo.back();
+				todo.pop_back();
+				if (link s = other.node(t.first).son)
+					copy_siblings(other, s, t.second, node(t.second).son, todo);
+			}
+		} catch (...) {
+			clear();
+			throw;
 		}
 	}
 public:
 	typedef Element Element;
-	PairingHeap(int max_size) :
-			sz(0), maxsz(max_size), root(0) {
-		pos = new PHNode*[max_size];
-		memset(pos, 0, max_size * sizeof(PHNode*));
+	/**
+	 * An opaque reference to an element, returned by insert and emplace.
+	 * It stays valid until the element leaves the pq, whatever happens to its key or to the other elements.
+	 * After a meld, the handles of the other pq refer to the same elements in this one.
+	 * A default constructed handle refers to no element.
+	 */
+	class Handle {
+		friend class PairingHeap;
+		link x;
+		explicit Handle(link x) :
+				x(x) {
+		}
+	public:
+		Handle() :
+				x(0) {
+		}
+		bool operator==(const Handle &h) const {
+			return x == h.x;
+		}
+		bool operator!=(const Handle &h) const {
+			return x != h.x;
+		}
+	};
+	PairingHeap() :
+			sz(0), maxsz(max_ids()), root(0), aux(0), counter(), nranks(0) {
+	}
+	PairingHeap(size_t max_size) :
+			sz(0), maxsz(max_size), store(max_size), root(0), aux(0), counter(), nranks(
+					0) {
+	}
+	/**
+	 * makes a copy of other, with the same elements, maximal size, statistics and shape of the trees,
+	 * e.g. a snapshot of the frontier in a speculative search. The handles of other don't refer to the copy,
+	 * except with PH_IndexLayout, where the links are the same.
+	 * Algo:
+	 * 		with PH_IndexLayout, copy the node array, with a single memcpy for trivially copyable keys.
+	 * 		Otherwise copy the nodes one by one with their links, without any comparison.
+	 */
+	PairingHeap(const PairingHeap &other) :
+			sz(other.sz), maxsz(other.maxsz), less(other.less), st(other.st), root(
+					0), aux(0), counter(), nranks(0) {
+		copy_trees(other, std::integral_constant<bool, Storage::by_index>());
 	}
+	// there's no swap of the layouts to build it on; use clone, or clear and meld.
+	PairingHeap &operator=(const PairingHeap &) = delete;
 	~PairingHeap() {
-		delete[] pos;
 		if (root)
-			recursively_destruct(root);
+			destruct(root);
+		if (aux)
+			destruct(aux);
+	}
+	/**
+	 * removes all elements.
+	 * The space for the addressability and the nodes is kept for reuse.
+	 */
+	void clear() {
+		if (root)
+			destruct(root);
+		if (aux)
+			destruct(aux);
+		root = aux = 0;
+		reset_counter();
+		sz = 0;
+	}
+	/**
+	 * returns the number of bytes held by the pq: the object itself, the map from the id's and the nodes.
+	 * With PH_NewAlloc, only the nodes in use are counted, without the overhead of the global heap.
+	 */
+	size_t memory_bytes() const {
+		return sizeof(*this) + store.memory_bytes();
+	}
+	/**
+	 * makes room for n elements in total (at most max_size), e.g. before a known burst,
+	 * so that inserting them with id's below n doesn't allocate.
+	 */
+	void reserve(size_t n) {
+		n = std::min(n, maxsz);
+		store.reserve(n, n > sz ? n - sz : 0);
+	}
+	/**
+	 * gives back the space not needed by the current elements, e.g. after a burst.
+	 * The map from the id's is cut after the largest id in use, and the free nodes of PH_PoolAlloc are released
+	 * where whole slabs are free. No element moves, except with PH_IndexLayout, where the array is copied.
+	 * Takes O(size of the id map) time, plus O(f log f) for f free nodes with PH_PoolAlloc.
+	 */
+	void shrink_to_fit() {
+		store.shrink_to_fit();
+	}
+	/**
+	 * returns a copy of the pq, see the copy constructor.
+	 */
+	PairingHeap clone() const {
+		return PairingHeap(*this);
+	}
+	/**
+	 * returns the statistics collected so far.
+	 */
+	const Stats &stats() const {
+		return st;
 	}
 	/**
 	 * returns the current size.
@@ -259,68 +2074,250 @@ public:
 	 * determines whether there's an element in the pq with the given id.
 	 * This won't throw any exceptions.
 	 */
-	bool contains(int id) {
-		return id >= 0 && id < maxsz && pos[id] != 0;
+	bool contains(Id id) const {
+		return valid_id(id) && store.find(id) != 0;
 	}
 	/**
 	 * returns the current key of the element with the given id.
 	 * Throws an exception if the id is invalid or there's no element with that id.
 	 */
-	const T &get_key(int id) const {
+	const T &get_key(Id id) const {
 		ensure_existing(id);
-		return pos[id]->elem.key;
+		return get_key_unchecked(id);
 	}
 	/**
 	 * try to insert an element with the given id and key.
 	 * Throws an exception if the id is invalid or there's already an element with that id.
 
 	 * Algo:
-	 *		make a new node and merge it with the current root.
+	 *		make a new node and merge it with the current root (or put it into the auxiliary list).
 	 */
-	void insert(int id, const T& key) {
+	Handle insert(Id id, const T& key) {
 		ensure_not_existing(id);
-		PHNode *p = new PHNode(Element(id, key));
-		pos[id] = p;
-		root = root ? merge(root, p) : p;
-		++sz;
+		return emplace_unchecked(id, key);
+	}
+	Handle insert(Id id, T&& key) {
+		ensure_not_existing(id);
+		return emplace_unchecked(id, std::move(key));
+	}
+	/**
+	 * try to insert an element with the given id, whose key is constructed in place from args.
+	 * Throws an exception if the id is invalid or there's already an element with that id.
+	 */
+	template<typename ... Args>
+	Handle emplace(Id id, Args&&... args) {
+		ensure_not_existing(id);
+		return emplace_unchecked(id, std::forward<Args>(args)...);
+	}
+	/**
+	 * inserts all elements in the range [first, last) of (id, key) pairs, e.g. std::pair<int, T>.
+	 * It must be possible to iterate over the range twice.
+	 * Throws an exception if some id is invalid or used twice, and then no element is inserted.
+	 * Algo:
+	 * 		1. Validate all id's.
+	 * 		2. Make the new nodes siblings of each other, and combine them to a single root.
+	 * 		3. Merge it with the current root.
+	 * 		With an auxiliary list, the new siblings are simply appended to it instead.
+	 */
+	template<typename It>
+	void insert_bulk(It first, It last) {
+		for (It it = first; it != last; ++it)
+			ensure_not_existing(it->first);
+		link head = 0;
+		size_t n = 0;
+		try {
+			for (It it = first; it != last; ++it) {
+				// an id might be repeated in the range.
+				if (store.find(it->first))
+					throw PH_EX_ALREADY_EXISTS;
+				link p = store.create(it->first, it->second);
+				if (head) { // append p to the circular list of siblings.
+					link tail = node(head).left;
+					node(p).left = tail;
+					node(p).right = head;
+					node(tail).right = p;
+					node(head).left = p;
+				} else
+					head = p;
+				++n;
+			}
+		} catch (...) {
+			if (head) {
+				link p = head;
+				do {
+					link p2 = node(p).right;
+					store.destroy(p);
+					p = p2;
+				} while (p != head);
+			}
+			throw;
+		}
+		if (head == 0)
+			return;
+		if (Variant::auxiliary)
+			defer(head);
+		else {
+			head = combine_siblings(head);
+			root = root ? merge(root, head) : head;
+		}
+		sz += n;
 	}
 	/**
 	 * returns the current minimal element in the priority queue.
 	 * Throws an exception if the pq is empty.
+	 * With an auxiliary variant, it consolidates the trees, see peek_k.
 	 */
 	const Element &find_min() const {
 		ensure_nonempty();
-		return root->elem;
+		// the consolidation only writes to mutable members, and doesn't change the elements in the pq.
+		if (Variant::auxiliary)
+			const_cast<PairingHeap *>(this)->consolidate();
+		return node(root).elem;
+	}
+	/**
+	 * writes (copies of) the k smallest elements (or all, if there are fewer) to out in sorted order,
+	 * without changing the pq. Returns the output iterator after the last element written.
+	 * With an auxiliary variant, the trees are consolidated first. That only writes to mutable members,
+	 * but it's a write: a pq read by several threads at the same time needs a lock around it.
+	 * Algo:
+	 * 		walk the tree best-first: keep the candidates in a small binary heap, starting with the root.
+	 * 		Output the smallest candidate and replace it by its children, following the son and right links.
+	 * 		It takes O(k logk + d) time, where d is the total number of children of the k nodes output.
+	 */
+	template<typename OutIt>
+	OutIt peek_k(size_t k, OutIt out) const {
+		if (Variant::auxiliary)
+			const_cast<PairingHeap *>(this)->consolidate();
+		if (root == 0)
+			return out;
+		// the candidates, as a binary heap with the smallest key on top.
+		std::vector<link> cand(1, root);
+		PairingHeap *self = const_cast<PairingHeap *>(this);
+		auto greater = [self](link a, link b) {
+			return self->less_elem(self->node(b).elem, self->node(a).elem);
+		};
+		for (; k > 0 && !cand.empty(); --k) {
+			std::pop_heap(cand.begin(), cand.end(), greater);
+			link x = cand.back();
+			cand.pop_back();
+			*out = node(x).elem;
+			++out;
+			if (link c = node(x).son)
+				do {
+					cand.push_back(c);
+					std::push_heap(cand.begin(), cand.end(), greater);
+					c = node(c).right;
+				} while (c != node(x).son);
+		}
+		return out;
+	}
+	/**
+	 * calls fn(elem) for every element in the pq, in no particular order, with a const reference to it.
+	 * Algo:
+	 * 		scan the map from the id's (or the node array of PH_IndexLayout) linearly, instead of walking the tree.
+	 * 		It takes time linear in the size of the map rather than in the number of elements.
+	 */
+	template<typename F>
+	void for_each(F fn) const {
+		visit(fn, std::integral_constant<bool, Storage::by_id>());
+	}
+	/**
+	 * starts to load the node of the element with the given id into the cache, so that a
+	 * decrease_key (or any other operation) on it a little later doesn't wait for the memory.
+	 * It does nothing if the id is invalid or there's no element with that id, and won't throw any exceptions.
+	 */
+	void prefetch(Id id) const {
+		if (valid_id(id))
+			store.prefetch(id);
 	}
 	/**
 	 * removes and returns the current minimum in the pq.
+	 * The element is moved out of the heap.
 	 * Throws an exception if the pq is empty.
 	 * Algo:
 	 * 		remove the root and combine the children of the root.
 	 */
 	Element delete_min() {
 		ensure_nonempty();
-		Element r = root->elem;
-		pos[r.id] = 0;
-		PHNode *rson = root->son;
-		delete root;
-		--sz;
-		root = combine_siblings(rson);
-		return r;
+		return delete_min_unchecked();
+	}
+	/**
+	 * removes the k smallest elements (or all, if there are fewer) and writes them to out in sorted order.
+	 * The elements are moved out of the heap. Returns the output iterator after the last element written.
+	 * Algo:
+	 * 		like k delete_min's, but the auxiliary list is consolidated and the size updated only once.
+	 */
+	template<typename OutIt>
+	OutIt extract_k(size_t k, OutIt out) {
+		consolidate();
+		k = std::min(k, sz);
+		sz -= k;
+		for (; k > 0; --k) {
+			*out = std::move(node(root).elem);
+			++out;
+			link rson = node(root).son;
+			store.destroy(root);
+			root = combine_siblings(rson);
+		}
+		return out;
+	}
+	/**
+	 * removes all elements whose key isn't larger than bound, and writes them to out in sorted order.
+	 * The elements are moved out of the heap. Returns the output iterator after the last element written.
+	 * Algo:
+	 * 		like extract_k, until the root is larger than bound.
+	 * 		(Cutting the whole subtree of such elements and combining the rest once was measured to be slower:
+	 * 		it reads the children which stay twice, once to compare them with bound and once to combine them.)
+	 */
+	template<typename OutIt>
+	OutIt extract_until(const T &bound, OutIt out) {
+		consolidate();
+		while (root && !less_key(bound, node(root).elem.key)) {
+			*out = std::move(node(root).elem);
+			++out;
+			link rson = node(root).son;
+			store.destroy(root);
+			--sz;
+			root = combine_siblings(rson);
+		}
+		return out;
+	}
+	/**
+	 * removes all elements and writes them to out in sorted order.
+	 * The elements are moved out of the heap. Returns the output iterator after the last element written.
+	 * Algo:
+	 * 		move all elements to a buffer while disposing the tree in one pass, and sort the buffer.
+	 * 		This saves the pointer chasing of n combinings.
+	 */
+	template<typename OutIt>
+	OutIt drain_sorted(OutIt out) {
+		std::vector<Element> all;
+		all.reserve(sz);
+		if (root)
+			destruct(root, &all);
+		if (aux)
+			destruct(aux, &all);
+		root = aux = 0;
+		reset_counter();
+		sz = 0;
+		std::sort(all.begin(), all.end(),
+				[this](const Element &a, const Element &b) {
+					return less_elem(a, b);
+				});
+		return std::move(all.begin(), all.end(), out);
 	}
 
 	/**
 	 * removes and returns the element with the given id.
+	 * The element is moved out of the heap.
 	 * Throws an exception if the id is invalid or there's no element with that id.
 	 * Algo:
-	 * 		1. Decrease the key to the current minimum;
-	 * 			Note that decrease_key will make sure the node to remove will be the new root.
-	 *		2. Delete_min
+	 * 		1. Cut the node with that id from the heap.
+	 *		2. Combine the children of the node and merge the result with the root (or put it into the auxiliary list).
 	 */
-	Element remove(int id) {
+	Element remove(Id id) {
 		ensure_existing(id);
-		decrease_key(id, root->elem.key);
-		return delete_min();
+		return remove_unchecked(id);
 	}
 
 	/**
@@ -329,52 +2326,300 @@ public:
 	 * It does nothing if newkey is larger than the current key of the element.
 	 * If the new key is as small as the root, that node will be the made the new root, even if its current key equals to the new one.
 	 * Algo:
-	 * 		cut the node with that id from the heap and then merge the subtree with the root.
-	 */
-	void decrease_key(int id, const T& newkey) {
-		if (!less(get_key(id), newkey)) {
-			PHNode *p = pos[id];
-			// if the node is the root, we're happy.
-			if (p == root)
-				p->elem.key = newkey;
-			else {
-				// if the node is the only child of its parent
-				if (p->left == p) {
-					PHNode *pp = p->parent;
-					pp->son = 0;
-					p->parent = 0;
-				} else { // else, it has siblings
-					PHNode *pp = p->parent;
-					// if its parent points to this node, point to another sibling.
-					if (pp->son == p)
-						pp->son = p->left;
-					p->parent = 0;
-					p->left->right = p->right;
-					p->right->left = p->left;
-					p->left = p->right = p;
-				}
-				// do the change, and merge.
-				p->elem.key = newkey;
-				// this ordering of the arguments makes sure that if they have the same key, the new node will be the root.
-				root = merge(p, root);
-			}
+	 * 		cut the node with that id from the heap and then merge the subtree with the root
+	 * 		(or put it into the auxiliary list).
+	 */
+	void decrease_key(Id id, const T& newkey) {
+		ensure_existing(id);
+		decrease(store.find(id), newkey);
+	}
+	void decrease_key(Id id, T&& newkey) {
+		ensure_existing(id);
+		decrease(store.find(id), std::move(newkey));
+	}
+
+	/**
+	 * decreases the keys of all elements in the range [first, last) of (id, newkey) pairs, e.g. std::pair<int, T>.
+	 * Like a series of decrease_key's, but the cut subtrees are merged with the root only once.
+	 * It must be possible to iterate over the range twice.
+	 * Throws an exception if some id is invalid or there's no element with that id, and then no key is changed.
+	 * Algo:
+	 * 		1. Validate all id's.
+	 * 		2. Cut the subtrees of the decreased nodes and make them siblings of each other.
+	 * 		3. Combine them to a single root and merge it with the current root.
+	 * 		With an auxiliary list, the cut subtrees are simply appended to it instead.
+	 */
+	template<typename It>
+	void decrease_key_batch(It first, It last) {
+		for (It it = first; it != last; ++it)
+			ensure_existing(it->first);
+		link head = 0;
+		for (It it = first; it != last; ++it) {
+			link x = lower(store.find(it->first), it->second);
+			if (x)
+				head = splice(head, x);
 		}
+		if (head == 0)
+			return;
+		if (!Variant::auxiliary)
+			head = combine_siblings(head);
+		put_back(head);
+	}
+
+	/**
+	 * try to increase the key of the element with the given id.
+	 * Throws an exception if the id is invalid or there's no element with that id.
+	 * It does nothing if newkey is smaller than the current key of the element.
+	 * Algo:
+	 * 		change a leaf in place. Otherwise cut the node, combine its children,
+	 * 		and merge both with the root (or put them into the auxiliary list).
+	 */
+	void increase_key(Id id, const T& newkey) {
+		ensure_existing(id);
+		increase(store.find(id), newkey);
+	}
+	void increase_key(Id id, T&& newkey) {
+		ensure_existing(id);
+		increase(store.find(id), std::move(newkey));
+	}
+	/**
+	 * changes the key of the element with the given id to newkey, whether it's smaller or larger than the current one.
+	 * Throws an exception if the id is invalid or there's no element with that id.
+	 */
+	void update_key(Id id, const T& newkey) {
+		ensure_existing(id);
+		update(store.find(id), newkey);
+	}
+	void update_key(Id id, T&& newkey) {
+		ensure_existing(id);
+		update(store.find(id), std::move(newkey));
+	}
+
+	/**
+	 * The exception-free operations.
+	 * They return false (and do nothing) where the operations above would throw an exception.
+	 */
+	bool try_insert(Id id, const T& key) {
+		if (!valid_id(id) || store.find(id))
+			return false;
+		emplace_unchecked(id, key);
+		return true;
+	}
+	bool try_insert(Id id, T&& key) {
+		if (!valid_id(id) || store.find(id))
+			return false;
+		emplace_unchecked(id, std::move(key));
+		return true;
+	}
+	bool try_delete_min(Element &min) {
+		if (sz == 0)
+			return false;
+		min = delete_min_unchecked();
+		return true;
+	}
+
+	/**
+	 * The unchecked operations.
+	 * The caller guarantees what the operations above check. This is only asserted in debug builds.
+	 */
+	const T &get_key_unchecked(Id id) const {
+		assert(contains(id));
+		return node(store.find(id)).elem.key;
+	}
+	Handle insert_unchecked(Id id, const T& key) {
+		return emplace_unchecked(id, key);
+	}
+	Handle insert_unchecked(Id id, T&& key) {
+		return emplace_unchecked(id, std::move(key));
+	}
+	template<typename ... Args>
+	Handle emplace_unchecked(Id id, Args&&... args) {
+		assert(valid_id(id) && !store.find(id));
+		link p = store.create(id, std::forward<Args>(args)...);
+		if (Variant::auxiliary)
+			defer(p);
+		else
+			root = root ? merge(root, p) : p;
+		++sz;
+		return Handle(p);
+	}
+
+	/**
+	 * The operations on handles.
+	 * The handle must refer to an element in this pq, which can't be checked. No id is looked up.
+	 */
+	Handle handle(Id id) const {
+		ensure_existing(id);
+		return Handle(store.find(id));
+	}
+	const Element &get(Handle h) const {
+		assert(h.x);
+		return node(h.x).elem;
+	}
+	const T &get_key(Handle h) const {
+		return get(h).key;
+	}
+	Element remove(Handle h) {
+		assert(h.x);
+		return remove_node(h.x);
+	}
+	void decrease_key(Handle h, const T& newkey) {
+		assert(h.x);
+		decrease(h.x, newkey);
+	}
+	void decrease_key(Handle h, T&& newkey) {
+		assert(h.x);
+		decrease(h.x, std::move(newkey));
+	}
+	void increase_key(Handle h, const T& newkey) {
+		assert(h.x);
+		increase(h.x, newkey);
+	}
+	void increase_key(Handle h, T&& newkey) {
+		assert(h.x);
+		increase(h.x, std::move(newkey));
+	}
+	void update_key(Handle h, const T& newkey) {
+		assert(h.x);
+		update(h.x, newkey);
+	}
+	void update_key(Handle h, T&& newkey) {
+		assert(h.x);
+		update(h.x, std::move(newkey));
+	}
+	void prefetch(Handle h) const {
+		if (h.x)
+			PH_PREFETCH(&store[h.x]);
+	}
+	Element delete_min_unchecked() {
+		assert(sz > 0);
+		consolidate();
+		return pop_root();
+	}
+	Element remove_unchecked(Id id) {
+		assert(contains(id));
+		return remove_node(store.find(id));
+	}
+	void decrease_key_unchecked(Id id, const T& newkey) {
+		assert(contains(id));
+		decrease(store.find(id), newkey);
+	}
+	void decrease_key_unchecked(Id id, T&& newkey) {
+		assert(contains(id));
+		decrease(store.find(id), std::move(newkey));
+	}
+	void increase_key_unchecked(Id id, const T& newkey) {
+		assert(contains(id));
+		increase(store.find(id), newkey);
+	}
+	void increase_key_unchecked(Id id, T&& newkey) {
+		assert(contains(id));
+		increase(store.find(id), std::move(newkey));
+	}
+	void update_key_unchecked(Id id, const T& newkey) {
+		assert(contains(id));
+		update(store.find(id), newkey);
+	}
+	void update_key_unchecked(Id id, T&& newkey) {
+		assert(contains(id));
+		update(store.find(id), std::move(newkey));
+	}
+
+	/**
+	 * moves all elements of other into this pq, leaving other empty.
+	 * No id may be used in both heaps.
+	 * Algo:
+	 * 		take over the nodes and the id's of other, and merge the two roots.
+	 */
+	void meld(PairingHeap &other) {
+		if (&other == this || other.sz == 0)
+			return;
+		store.take_over(other.store);
+		if (Variant::auxiliary) {
+			link trees = splice(other.root, other.aux);
+			other.root = other.aux = 0;
+			other.reset_counter();
+			defer(trees);
+		} else
+			root = root ? merge(root, other.root) : other.root;
+		sz += other.sz;
+		maxsz = std::max(maxsz, other.maxsz);
+		other.root = other.aux = 0;
+		other.sz = 0;
+	}
+
+	/**
+	 * writes a snapshot of the pq to out, which load reads back.
+	 * Only for PH_IndexLayout and trivially copyable keys. The statistics and the comparator aren't saved.
+	 * The format is a header of 64 bytes followed by the node array as it is in memory,
+	 * so it can only be loaded on machines with the same byte order and type sizes.
+	 * Errors are reported by the state of out, like with out.write.
+	 * Algo:
+	 * 		the links are indices into the node array, so they are valid in any copy of it.
+	 */
+	void save(std::ostream &out) const {
+		Image h = header();
+		out.write(reinterpret_cast<const char *>(&h), sizeof h);
+		store.write(out);
+	}
+	/**
+	 * replaces the elements of the pq by a snapshot written by save, including its maximal size.
+	 * Throws an exception if in doesn't hold a snapshot of this type of heap, and then the pq is empty.
+	 * Only the header and the length are checked; a snapshot with corrupt nodes gives undefined behavior.
+	 * It takes time linear in the size of the snapshot, with no insert or link.
+	 */
+	void load(std::istream &in) {
+		clear();
+		Image h;
+		if (!in.read(reinterpret_cast<char *>(&h), sizeof h) || !valid(h)
+				|| !store.read(in, h.capacity))
+			throw PH_EX_BAD_IMAGE;
+		restore(h);
+	}
+	/**
+	 * like load, but uses the snapshot of the given size at image in place, e.g. a file mapped with mmap
+	 * (with PROT_READ | PROT_WRITE and MAP_PRIVATE, so that the changes don't go to the file).
+	 * Nothing is read or relinked, so it takes constant time, and the pages are brought in as they are touched.
+	 * (An incremental variant links the auxiliary trees of the snapshot into its counter, though.)
+	 * The memory stays the caller's and is written to. It must outlive the pq, until the next load,
+	 * or until an insert with an uncovered id makes the pq copy the nodes to its own array.
+	 * image must be aligned like a node, which a mapped file is.
+	 */
+	void load(void *image, size_t bytes) {
+		clear();
+		Image h;
+		if (bytes < sizeof h)
+			throw PH_EX_BAD_IMAGE;
+		memcpy(&h, image, sizeof h);
+		if (!valid(h) || reinterpret_cast<uintptr_t>(image) % alignof(PHNode)
+				|| (bytes - sizeof h) / sizeof(PHNode) <= h.capacity)
+			throw PH_EX_BAD_IMAGE;
+		store.attach(static_cast<char *>(image) + sizeof h, size_t(h.capacity));
+		restore(h);
 	}
 };
 
 /**
  * The following are possible exceptions.
  */
-template<typename T, typename Comparator>
-const PH_Exception PairingHeap<T, Comparator>::PH_EX_ALREADY_EXISTS(
+template<typename T, typename Comparator, template<typename > class NodeAlloc,
+		typename Layout, typename Variant, typename Stats, typename Id>
+const PH_Exception PairingHeap<T, Comparator, NodeAlloc, Layout, Variant, Stats, Id>::PH_EX_ALREADY_EXISTS(
 		"An element with the same ID already exists.");
-template<typename T, typename Comparator>
-const PH_Exception PairingHeap<T, Comparator>::PH_EX_EMPTY(
+template<typename T, typename Comparator, template<typename > class NodeAlloc,
+		typename Layout, typename Variant, typename Stats, typename Id>
+const PH_Exception PairingHeap<T, Comparator, NodeAlloc, Layout, Variant, Stats, Id>::PH_EX_EMPTY(
 		"The heap is empty!");
-template<typename T, typename Comparator>
-const PH_Exception PairingHeap<T, Comparator>::PH_EX_BAD_ID("ID out of range!");
-template<typename T, typename Comparator>
-const PH_Exception PairingHeap<T, Comparator>::PH_EX_NO_SUCH_ELEMENT(
+template<typename T, typename Comparator, template<typename > class NodeAlloc,
+		typename Layout, typename Variant, typename Stats, typename Id>
+const PH_Exception PairingHeap<T, Comparator, NodeAlloc, Layout, Variant, Stats, Id>::PH_EX_BAD_ID("ID out of range!");
+template<typename T, typename Comparator, template<typename > class NodeAlloc,
+		typename Layout, typename Variant, typename Stats, typename Id>
+const PH_Exception PairingHeap<T, Comparator, NodeAlloc, Layout, Variant, Stats, Id>::PH_EX_NO_SUCH_ELEMENT(
 		"The heap contains no element with this ID!");
+template<typename T, typename Comparator, template<typename > class NodeAlloc,
+		typename Layout, typename Variant, typename Stats, typename Id>
+const PH_Exception PairingHeap<T, Comparator, NodeAlloc, Layout, Variant, Stats, Id>::PH_EX_BAD_IMAGE(
+		"Not a valid snapshot of the heap!");
 
 #endif /* PAIRINGHEAP_H_ */
@@ -0,0 +1,955 @@
+//============================================================================
+// Name        : PairingHeapBench.cpp
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : Benchmarks for PairingHeap.h
+//
+// Build:  g++ -std=c++11 -O2 -pthread PairingHeapBench.cpp -o bench
+// Usage:  bench [--latency] [max_n [filter]]
+//         Sizes 10^3, 10^4, ..., max_n are run (default max_n = 10^6).
+//         Only the structures whose name contains filter are run.
+// Output: one CSV line per (structure, workload, n):
+//         structure,workload,n,ops,ns_per_op,mops_per_s
+//         With --latency, every operation is timed on its own instead, and the percentiles are printed:
+//         structure,workload,n,ops,p50_ns,p99_ns,p999_ns,max_ns
+//============================================================================
+
+#include "PairingHeap.h"
+#include "ConcurrentPairingHeap.h"
+#include "DaryHeap.h"
+#include "MultiPairingHeap.h"
+#include "RadixHeap.h"
+#include "RankPairingHeap.h"
+#include "SplitPairingHeap.h"
+#include "TimerQueue.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+using namespace std;
+
+/**
+ * A small deterministic random number generator (xorshift64*),
+ * so that every structure sees exactly the same input.
+ */
+struct Rng {
+	unsigned long long s;
+	Rng(unsigned long long seed) :
+			s(seed * 2685821657736338717ULL + 1) {
+	}
+	unsigned long long next() {
+		s ^= s >> 12;
+		s ^= s << 25;
+		s ^= s >> 27;
+		return s * 2685821657736338717ULL;
+	}
+	// uniform in [0, n)
+	int below(int n) {
+		return int(next() % (unsigned long long) n);
+	}
+};
+
+/**
+ * The element type returned by the structures which are not PairingHeaps.
+ */
+struct Item {
+	int id;
+	int key;
+	Item(int id, int key) :
+			id(id), key(key) {
+	}
+};
+
+/**
+ * std::priority_queue behind the same interface, without addressability.
+ * Only used for the workloads that need no decrease_key or remove.
+ */
+class StdPQ {
+	priority_queue<pair<int, int>, vector<pair<int, int> >,
+			greater<pair<int, int> > > q;
+public:
+	StdPQ(int) {
+	}
+	size_t size() const {
+		return q.size();
+	}
+	void insert(int id, int key) {
+		q.push(make_pair(key, id));
+	}
+	Item delete_min() {
+		Item r(q.top().second, q.top().first);
+		q.pop();
+		return r;
+	}
+};
+
+/**
+ * A PairingHeap behind one mutex, as the baseline of the concurrent workloads.
+ */
+class LockedPairingHeap {
+	PairingHeap<int> h;
+	mutex m;
+public:
+	typedef PairingHeap<int>::Element Element;
+	LockedPairingHeap(int max_size) :
+			h(max_size) {
+	}
+	void insert(int id, int key) {
+		lock_guard<mutex> lock(m);
+		h.insert(id, key);
+	}
+	bool try_delete_min(Element &min) {
+		lock_guard<mutex> lock(m);
+		return h.try_delete_min(min);
+	}
+};
+
+typedef chrono::steady_clock Clock;
+
+static double elapsed_ns(Clock::time_point since) {
+	return chrono::duration<double, nano>(Clock::now() - since).count();
+}
+
+// keeps the compiler from dropping the results.
+static long long checksum = 0;
+
+static const char *filter = "";
+
+static void report(const char *structure, const char *workload, long long n,
+		long long ops, double ns) {
+	printf("%s,%s,%lld,%lld,%.2f,%.3f\n", structure, workload, n, ops,
+			ns / ops, ops / ns * 1000.0);
+	fflush(stdout);
+}
+
+/**
+ * A histogram of latencies in ns, with 16 buckets per power of two (so within 6.25%) and the exact maximum.
+ * The values below 16 have a bucket each.
+ */
+struct Histogram {
+	static const int SUB = 16;
+	vector<long long> count;
+	long long total, max_ns;
+	Histogram() :
+			count(61 * SUB), total(0), max_ns(0) {
+	}
+	static int bucket(long long ns) {
+		if (ns < SUB)
+			return int(max(ns, 0LL));
+		int e = 4;
+		while (ns >> (e + 1))
+			++e;
+		return (e - 3) * SUB + int(ns >> (e - 4)) - SUB;
+	}
+	// the largest value in bucket b.
+	static long long upper(int b) {
+		if (b < SUB)
+			return b;
+		int e = b / SUB + 3;
+		return ((long long) (SUB + b % SUB + 1) << (e - 4)) - 1;
+	}
+	void add(long long ns) {
+		++count[bucket(ns)];
+		++total;
+		max_ns = max(max_ns, ns);
+	}
+	// the value which a fraction p of the samples doesn't exceed, rounded up to its bucket.
+	long long percentile(double p) const {
+		long long rank = (long long) ceil(p * total), seen = 0;
+		for (size_t b = 0; b < count.size(); ++b)
+			if ((seen += count[b]) >= rank && seen > 0)
+				return min(upper(int(b)), max_ns);
+		return max_ns;
+	}
+};
+
+// the time of the single operation started at since, in ns.
+static long long latency_ns(Clock::time_point since) {
+	return chrono::duration_cast<chrono::nanoseconds>(Clock::now() - since).count();
+}
+
+static void report_latency(const char *structure, const char *workload,
+		long long n, const Histogram &h) {
+	printf("%s,%s,%lld,%lld,%lld,%lld,%lld,%lld\n", structure, workload, n,
+			h.total, h.percentile(0.5), h.percentile(0.99),
+			h.percentile(0.999), h.max_ns);
+	fflush(stdout);
+}
+
+/**
+ * A directed graph in adjacency array form.
+ */
+struct Graph {
+	int n;
+	vector<int> first, to, w;
+};
+
+// builds a graph from an edge list.
+static Graph make_graph(int n, vector<pair<int, int> > &edges, vector<int> &w) {
+	Graph g;
+	g.n = n;
+	g.first.assign(n + 1, 0);
+	for (size_t i = 0; i < edges.size(); ++i)
+		++g.first[edges[i].first + 1];
+	for (int i = 0; i < n; ++i)
+		g.first[i + 1] += g.first[i];
+	g.to.resize(edges.size());
+	g.w.resize(edges.size());
+	vector<int> fill(g.first.begin(), g.first.end() - 1);
+	for (size_t i = 0; i < edges.size(); ++i) {
+		int k = fill[edges[i].first]++;
+		g.to[k] = edges[i].second;
+		g.w[k] = w[i];
+	}
+	return g;
+}
+
+/**
+ * A side x side 4-neighbour grid with random weights in [1, 100].
+ */
+static Graph grid_graph(int n, Rng &rng) {
+	int side = max(2, int(sqrt(double(n))));
+	vector<pair<int, int> > e;
+	vector<int> w;
+	for (int r = 0; r < side; ++r)
+		for (int c = 0; c < side; ++c) {
+			int v = r * side + c;
+			if (c + 1 < side) {
+				int x = 1 + rng.below(100);
+				e.push_back(make_pair(v, v + 1)), w.push_back(x);
+				e.push_back(make_pair(v + 1, v)), w.push_back(x);
+			}
+			if (r + 1 < side) {
+				int x = 1 + rng.below(100);
+				e.push_back(make_pair(v, v + side)), w.push_back(x);
+				e.push_back(make_pair(v + side, v)), w.push_back(x);
+			}
+		}
+	return make_graph(side * side, e, w);
+}
+
+/**
+ * A road-like graph: jittered points on a grid, each linked to some of its 8 neighbours
+ * (about 30% of the links are missing), weighted by the euclidean distance.
+ * A few long links play the role of highways.
+ */
+static Graph road_graph(int n, Rng &rng) {
+	int side = max(2, int(sqrt(double(n))));
+	int m = side * side;
+	vector<double> x(m), y(m);
+	for (int v = 0; v < m; ++v) {
+		x[v] = v % side + rng.below(1000) / 1000.0;
+		y[v] = v / side + rng.below(1000) / 1000.0;
+	}
+	vector<pair<int, int> > e;
+	vector<int> w;
+	for (int r = 0; r < side; ++r)
+		for (int c = 0; c < side; ++c) {
+			int v = r * side + c;
+			static const int dr[] = { 0, 1, 1, 1 }, dc[] = { 1, -1, 0, 1 };
+			for (int d = 0; d < 4; ++d) {
+				int r2 = r + dr[d], c2 = c + dc[d];
+				if (r2 >= side || c2 < 0 || c2 >= side || rng.below(10) < 3)
+					continue;
+				int u = r2 * side + c2;
+				int len = 1 + int(1000 * hypot(x[v] - x[u], y[v] - y[u]));
+				e.push_back(make_pair(v, u)), w.push_back(len);
+				e.push_back(make_pair(u, v)), w.push_back(len);
+			}
+		}
+	for (int i = 0; i < m / 100; ++i) {
+		int v = rng.below(m), u = rng.below(m);
+		int len = 1 + int(700 * hypot(x[v] - x[u], y[v] - y[u]));
+		e.push_back(make_pair(v, u)), w.push_back(len);
+		e.push_back(make_pair(u, v)), w.push_back(len);
+	}
+	return make_graph(m, e, w);
+}
+
+/**
+ * The workloads on addressable structures.
+ * Each one reports the time of its measured phase only.
+ */
+template<typename H>
+struct Workloads {
+	const char *name;
+	int n;
+	// the random keys.
+	vector<int> keys;
+
+	Workloads(const char *name, int n) :
+			name(name), n(n), keys(n) {
+		Rng rng(n);
+		for (int i = 0; i < n; ++i)
+			keys[i] = rng.below(1 << 30);
+	}
+
+	void insert_delete() {
+		H h(n);
+		Clock::time_point t = Clock::now();
+		for (int i = 0; i < n; ++i)
+			h.insert(i, keys[i]);
+		report(name, "insert", n, n, elapsed_ns(t));
+		t = Clock::now();
+		for (int i = 0; i < n; ++i)
+			checksum += h.delete_min().key;
+		report(name, "delete_min", n, n, elapsed_ns(t));
+	}
+
+	// streams all elements out in sorted order at once.
+	void drain_sorted() {
+		H h(n);
+		for (int i = 0; i < n; ++i)
+			h.insert(i, keys[i]);
+		vector<typename H::Element> out;
+		out.reserve(n);
+		Clock::time_point t = Clock::now();
+		h.drain_sorted(back_inserter(out));
+		report(name, "drain_sorted", n, n, elapsed_ns(t));
+		checksum += out[n / 2].key;
+	}
+
+	void sorted(const char *workload, int dir) {
+		H h(n);
+		Clock::time_point t = Clock::now();
+		for (int i = 0; i < n; ++i)
+			h.insert(i, dir > 0 ? i : n - i);
+		for (int i = 0; i < n; ++i)
+			checksum += h.delete_min().key;
+		report(name, workload, n, 2LL * n, elapsed_ns(t));
+	}
+
+	// a long insert streak followed by a single delete_min, then alternating.
+	void adversarial() {
+		H h(n);
+		Clock::time_point t = Clock::now();
+		for (int i = 0; i < n; ++i)
+			h.insert(i, (i & 1) ? keys[i] : n - i);
+		for (int i = 0; i < n; ++i)
+			checksum += h.delete_min().key;
+		report(name, "sawtooth", n, 2LL * n, elapsed_ns(t));
+	}
+
+	// the hold model of event simulation: pop the next event and schedule a later one.
+	void hold() {
+		H h(n);
+		for (int i = 0; i < n; ++i)
+			h.insert(i, keys[i] >> 10);
+		Rng rng(7);
+		Clock::time_point t = Clock::now();
+		for (int i = 0; i < n; ++i) {
+			Item e = item(h.delete_min());
+			h.insert(e.id, e.key + 1 + rng.below(1 << 20));
+		}
+		report(name, "hold", n, n, elapsed_ns(t));
+	}
+
+	void decrease_key() {
+		H h(n);
+		for (int i = 0; i < n; ++i)
+			h.insert(i, keys[i]);
+		Rng rng(11);
+		Clock::time_point t = Clock::now();
+		for (int i = 0; i < n; ++i) {
+			int id = rng.below(n);
+			h.decrease_key(id, keys[id] -= 1 + rng.below(1 << 10));
+		}
+		report(name, "decrease_key", n, n, elapsed_ns(t));
+	}
+
+	// raising deadlines, as schedulers do.
+	void increase_key() {
+		H h(n);
+		for (int i = 0; i < n; ++i)
+			h.insert(i, keys[i]);
+		Rng rng(17);
+		Clock::time_point t = Clock::now();
+		for (int i = 0; i < n; ++i) {
+			int id = rng.below(n);
+			h.increase_key(id, keys[id] += 1 + rng.below(1 << 10));
+		}
+		report(name, "increase_key", n, n, elapsed_ns(t));
+	}
+
+	void remove() {
+		H h(n);
+		for (int i = 0; i < n; ++i)
+			h.insert(i, keys[i]);
+		vector<int> order(n);
+		for (int i = 0; i < n; ++i)
+			order[i] = i;
+		Rng rng(13);
+		for (int i = n - 1; i > 0; --i)
+			swap(order[i], order[rng.below(i + 1)]);
+		Clock::time_point t = Clock::now();
+		for (int i = 0; i < n; ++i)
+			checksum += h.remove(order[i]).key;
+		report(name, "remove", n, n, elapsed_ns(t));
+	}
+
+	// 50% insert, 25% delete_min, 25% decrease_key, starting half full.
+	void mixed() {
+		H h(n);
+		vector<int> free_ids, live;
+		for (int i = 0; i < n; ++i)
+			if (i & 1)
+				free_ids.push_back(i);
+			else
+				h.insert(i, keys[i]);
+		Rng rng(17);
+		Clock::time_point t = Clock::now();
+		for (int i = 0; i < n; ++i) {
+			int op = rng.below(4);
+			if (op < 2 && !free_ids.empty()) {
+				int id = free_ids.back();
+				free_ids.pop_back();
+				h.insert(id, keys[id]);
+			} else if (op == 2 && h.size()) {
+				free_ids.push_back(item(h.delete_min()).id);
+			} else {
+				int id = rng.below(n);
+				if (h.contains(id))
+					h.decrease_key(id, keys[id] -= 1 + rng.below(1 << 10));
+			}
+		}
+		report(name, "mixed", n, n, elapsed_ns(t));
+	}
+
+	// with batch, the decrease_key's of a settled vertex are issued at once.
+	// with ahead > 0, the heap prefetches the target of the edge that many edges ahead.
+	void dijkstra(const char *workload, const Graph &g, bool batch = false,
+			int ahead = 0) {
+		H h(g.n);
+		vector<long long> dist(g.n, -1);
+		vector<char> done(g.n, 0);
+		vector<pair<int, int> > relaxed;
+		long long ops = 0;
+		Clock::time_point t = Clock::now();
+		h.insert(0, 0);
+		dist[0] = 0;
+		while (h.size()) {
+			Item e = item(h.delete_min());
+			++ops;
+			done[e.id] = 1;
+			for (int k = g.first[e.id]; k < g.first[e.id + 1]; ++k) {
+				int u = g.to[k];
+				if (ahead && k + ahead < g.first[e.id + 1])
+					h.prefetch(g.to[k + ahead]);
+				long long d = e.key + g.w[k];
+				if (done[u] || (dist[u] >= 0 && dist[u] <= d))
+					continue;
+				if (dist[u] < 0)
+					h.insert(u, int(d));
+				else if (batch)
+					relaxed.push_back(make_pair(u, int(d)));
+				else
+					h.decrease_key(u, int(d));
+				dist[u] = d;
+				++ops;
+			}
+			if (!relaxed.empty()) {
+				h.decrease_key_batch(relaxed.begin(), relaxed.end());
+				relaxed.clear();
+			}
+		}
+		report(name, workload, g.n, ops, elapsed_ns(t));
+		checksum += dist[g.n - 1];
+	}
+
+	template<typename E>
+	static Item item(const E &e) {
+		return Item(e.id, e.key);
+	}
+};
+
+/**
+ * The latencies of the single operations on addressable structures, for the --latency mode.
+ * The long pauses (a delete_min combining a long list) vanish in the averages, not in the tails.
+ */
+template<typename H>
+struct Latencies {
+	const char *name;
+	int n;
+	vector<int> keys;
+
+	Latencies(const char *name, int n) :
+			name(name), n(n), keys(n) {
+		Rng rng(n);
+		for (int i = 0; i < n; ++i)
+			keys[i] = rng.below(1 << 30);
+	}
+
+	// fills h with all keys, and settles it with a delete_min and an insert.
+	void fill(H &h) {
+		for (int i = 0; i < n; ++i)
+			h.insert(i, keys[i]);
+		int id = h.delete_min().id;
+		h.insert(id, keys[id]);
+	}
+
+	void insert_delete() {
+		H h(n);
+		Histogram ins, del;
+		for (int i = 0; i < n; ++i) {
+			Clock::time_point t = Clock::now();
+			h.insert(i, keys[i]);
+			ins.add(latency_ns(t));
+		}
+		report_latency(name, "insert", n, ins);
+		for (int i = 0; i < n; ++i) {
+			Clock::time_point t = Clock::now();
+			checksum += h.delete_min().key;
+			del.add(latency_ns(t));
+		}
+		report_latency(name, "delete_min", n, del);
+	}
+
+	// bursts of up to 1024 inserts, each followed by as many delete_min's, on a half full heap.
+	// Only the delete_min's are timed: the first one after a burst pays for it with the auxiliary variants.
+	void burst() {
+		const int B = min(1024, n / 2);
+		H h(n);
+		vector<int> free_ids;
+		for (int i = 0; i < n; ++i)
+			if (i < n / 2)
+				h.insert(i, keys[i]);
+			else
+				free_ids.push_back(i);
+		Histogram del;
+		Rng rng(19);
+		for (int deleted = 0; deleted < n; deleted += B) {
+			for (int j = 0; j < B; ++j) {
+				h.insert(free_ids.back(), rng.below(1 << 30));
+				free_ids.pop_back();
+			}
+			for (int j = 0; j < B; ++j) {
+				Clock::time_point t = Clock::now();
+				int id = h.delete_min().id;
+				del.add(latency_ns(t));
+				free_ids.push_back(id);
+			}
+		}
+		report_latency(name, "burst_delete_min", n, del);
+	}
+
+	void decrease_key() {
+		H h(n);
+		fill(h);
+		Histogram dec;
+		Rng rng(11);
+		for (int i = 0; i < n; ++i) {
+			int id = rng.below(n);
+			int key = keys[id] -= 1 + rng.below(1 << 10);
+			Clock::time_point t = Clock::now();
+			h.decrease_key(id, key);
+			dec.add(latency_ns(t));
+		}
+		report_latency(name, "decrease_key", n, dec);
+	}
+
+	// half of the changes are up, half down.
+	void update_key() {
+		H h(n);
+		fill(h);
+		Histogram upd;
+		Rng rng(23);
+		for (int i = 0; i < n; ++i) {
+			int id = rng.below(n);
+			int key = keys[id] += rng.below(1 << 11) - (1 << 10);
+			Clock::time_point t = Clock::now();
+			h.update_key(id, key);
+			upd.add(latency_ns(t));
+		}
+		report_latency(name, "update_key", n, upd);
+	}
+
+	void remove() {
+		H h(n);
+		fill(h);
+		vector<int> order(n);
+		for (int i = 0; i < n; ++i)
+			order[i] = i;
+		Rng rng(13);
+		for (int i = n - 1; i > 0; --i)
+			swap(order[i], order[rng.below(i + 1)]);
+		Histogram rem;
+		for (int i = 0; i < n; ++i) {
+			Clock::time_point t = Clock::now();
+			checksum += h.remove(order[i]).key;
+			rem.add(latency_ns(t));
+		}
+		report_latency(name, "remove", n, rem);
+	}
+};
+
+/**
+ * Dijkstra with std::priority_queue, which has no decrease_key: stale entries are skipped.
+ */
+static void dijkstra_lazy(const char *workload, const Graph &g) {
+	StdPQ h(g.n);
+	vector<long long> dist(g.n, -1);
+	vector<char> done(g.n, 0);
+	long long ops = 0;
+	Clock::time_point t = Clock::now();
+	h.insert(0, 0);
+	dist[0] = 0;
+	while (h.size()) {
+		Item e = h.delete_min();
+		++ops;
+		if (done[e.id])
+			continue;
+		done[e.id] = 1;
+		for (int k = g.first[e.id]; k < g.first[e.id + 1]; ++k) {
+			int u = g.to[k];
+			long long d = e.key + g.w[k];
+			if (done[u] || (dist[u] >= 0 && dist[u] <= d))
+				continue;
+			h.insert(u, int(d));
+			dist[u] = d;
+			++ops;
+		}
+	}
+	report("std::priority_queue", workload, g.n, ops, elapsed_ns(t));
+	checksum += dist[g.n - 1];
+}
+
+template<typename H>
+static void run_addressable(const char *name, int n, const Graph &grid,
+		const Graph &road) {
+	if (!strstr(name, filter))
+		return;
+	Workloads<H> w(name, n);
+	w.insert_delete();
+	w.drain_sorted();
+	w.sorted("sorted_asc", 1);
+	w.sorted("sorted_desc", -1);
+	w.adversarial();
+	w.hold();
+	w.decrease_key();
+	w.increase_key();
+	w.remove();
+	w.mixed();
+	w.dijkstra("dijkstra_grid", grid);
+	w.dijkstra("dijkstra_road", road);
+	w.dijkstra("dijkstra_road_batch", road, true);
+	w.dijkstra("dijkstra_road_prefetch", road, false, 2);
+}
+
+/**
+ * p producer threads insert n elements in total, while one consumer thread deletes them all.
+ * Reports the throughput of the whole run.
+ */
+template<typename Q>
+static void producers_consumer(const char *name, int n, int p) {
+	if (!strstr(name, filter))
+		return;
+	Q q(n);
+	vector<thread> producers;
+	Clock::time_point t = Clock::now();
+	for (int k = 0; k < p; ++k)
+		producers.push_back(thread([&q, n, p, k]() {
+			Rng rng(k + 1);
+			for (int id = k; id < n; id += p)
+				q.insert(id, rng.below(1 << 30));
+		}));
+	typename Q::Element e;
+	long long sum = 0;
+	for (int left = n; left > 0;)
+		if (q.try_delete_min(e)) {
+			sum += e.key;
+			--left;
+		}
+	for (int k = 0; k < p; ++k)
+		producers[k].join();
+	string workload = "producers_" + to_string(p);
+	report(name, workload.c_str(), n, 2LL * n, elapsed_ns(t));
+	checksum += sum;
+}
+
+/**
+ * The hold model on p threads at the same time: each one repeatedly deletes a minimum and reinserts it later.
+ * The pq q holds n elements at the start.
+ */
+template<typename Q>
+static void parallel_hold(const char *name, Q &q, int n, int p) {
+	Rng rng(n);
+	for (int i = 0; i < n; ++i)
+		q.insert(i, rng.below(1 << 20));
+	vector<thread> threads;
+	Clock::time_point t = Clock::now();
+	for (int k = 0; k < p; ++k)
+		threads.push_back(thread([&q, n, p, k]() {
+			Rng rng(k + 1);
+			typename Q::Element e;
+			for (int i = k; i < n; i += p)
+				if (q.try_delete_min(e))
+					q.insert(e.id, e.key + 1 + rng.below(1 << 20));
+		}));
+	for (int k = 0; k < p; ++k)
+		threads[k].join();
+	string workload = "hold_threads_" + to_string(p);
+	report(name, workload.c_str(), n, 2LL * n, elapsed_ns(t));
+}
+
+// the concurrent workloads, for 1, 2, 4, ... producers up to the number of hardware threads.
+static void run_concurrent(int n) {
+	int threads = max(2u, thread::hardware_concurrency());
+	for (int p = 1; p <= threads; p *= 2) {
+		producers_consumer<ConcurrentPairingHeap<int> >("ConcurrentPairingHeap",
+				n, p);
+		producers_consumer<
+				ConcurrentPairingHeap<int, less<int>, PH_PoolAlloc,
+						PH_PointerLayout, PH_AuxTwoPass> >(
+				"ConcurrentPairingHeap/aux", n, p);
+		producers_consumer<LockedPairingHeap>("PairingHeap+mutex", n, p);
+		if (strstr("MultiPairingHeap", filter)) {
+			MultiPairingHeap<int, less<int>, PH_PoolAlloc> q(n, 4 * p);
+			parallel_hold("MultiPairingHeap", q, n, p);
+		}
+		if (strstr("PairingHeap+mutex", filter)) {
+			LockedPairingHeap q(n);
+			parallel_hold("PairingHeap+mutex", q, n, p);
+		}
+	}
+}
+
+/**
+ * A large value with a small key, for the payload workload.
+ */
+struct Job {
+	int due;
+	char data[124];
+};
+struct JobLess {
+	bool operator()(const Job &a, const Job &b) const {
+		return a.due < b.due;
+	}
+};
+struct DueOf {
+	int operator()(const Job &j) const {
+		return j.due;
+	}
+};
+
+// the due time of a deleted job.
+template<typename E>
+static int due(const E &e) {
+	return e.key.due;
+}
+static int due(const SplitPairingHeap<Job, DueOf>::Element &e) {
+	return e.payload.due;
+}
+
+/**
+ * The hold model with 128-byte values, which are kept in the nodes (PairingHeap)
+ * or apart from their keys (SplitPairingHeap).
+ */
+template<typename H>
+static void hold_payload(const char *name, int n) {
+	if (!strstr(name, filter))
+		return;
+	H h(n);
+	Rng rng(n);
+	Job j;
+	memset(j.data, 0, sizeof(j.data));
+	for (int i = 0; i < n; ++i) {
+		j.due = rng.below(1 << 20);
+		h.insert(i, j);
+	}
+	Clock::time_point t = Clock::now();
+	for (int i = 0; i < n; ++i) {
+		typename H::Element e = h.delete_min();
+		j.due = due(e) + 1 + rng.below(1 << 20);
+		h.insert(e.id, j);
+	}
+	report(name, "hold_payload128", n, n, elapsed_ns(t));
+}
+
+/**
+ * The interface of TimerQueue on a plain PairingHeap, which fires the timers with one delete_min each.
+ */
+struct DeleteMinTimers {
+	typedef PairingHeap<int, less<int>, PH_PoolAlloc> Heap;
+	typedef Heap::Element Timer;
+	Heap h;
+	DeleteMinTimers(int n) :
+			h(n) {
+	}
+	void schedule(int id, int deadline) {
+		h.insert(id, deadline);
+	}
+	void reschedule(int id, int deadline) {
+		h.update_key(id, deadline);
+	}
+	template<typename OutIt>
+	OutIt pop_expired(int now, OutIt out) {
+		while (h.size() && h.find_min().key <= now) {
+			*out = h.delete_min();
+			++out;
+		}
+		return out;
+	}
+};
+
+/**
+ * The timers of an event loop: n timers with deadlines in the next SPAN ticks.
+ * Every 64 ticks the expired ones are popped and scheduled again, and as many others are pushed back
+ * (a timeout reset on activity), until every timer has fired about once.
+ */
+template<typename Q>
+static void timers(const char *name, int n) {
+	if (!strstr(name, filter))
+		return;
+	const int SPAN = 1 << 16, TICK = 64;
+	Q q(n);
+	Rng rng(n);
+	for (int i = 0; i < n; ++i)
+		q.schedule(i, rng.below(SPAN));
+	vector<typename Q::Timer> out;
+	long long ops = 0;
+	Clock::time_point t = Clock::now();
+	for (int now = 0; now < SPAN; now += TICK) {
+		out.clear();
+		q.pop_expired(now, back_inserter(out));
+		for (size_t i = 0; i < out.size(); ++i)
+			q.schedule(out[i].id, now + 1 + rng.below(SPAN));
+		for (size_t i = 0; i < out.size(); ++i)
+			q.reschedule(rng.below(n), now + 1 + rng.below(SPAN));
+		ops += 2 * out.size();
+	}
+	report(name, "timers", n, ops, elapsed_ns(t));
+}
+
+// the workloads with monotone keys only, for RadixHeap.
+template<typename H>
+static void run_monotone(const char *name, int n, const Graph &grid,
+		const Graph &road) {
+	if (!strstr(name, filter))
+		return;
+	Workloads<H> w(name, n);
+	w.insert_delete();
+	w.drain_sorted();
+	w.sorted("sorted_asc", 1);
+	w.sorted("sorted_desc", -1);
+	w.adversarial();
+	w.hold();
+	w.decrease_key();
+	w.increase_key();
+	w.remove();
+	w.dijkstra("dijkstra_grid", grid);
+	w.dijkstra("dijkstra_road", road);
+	w.dijkstra("dijkstra_road_batch", road, true);
+	w.dijkstra("dijkstra_road_prefetch", road, false, 2);
+}
+
+template<typename H>
+static void run_latency(const char *name, int n) {
+	if (!strstr(name, filter))
+		return;
+	Latencies<H> l(name, n);
+	l.insert_delete();
+	l.burst();
+	l.decrease_key();
+	l.update_key();
+	l.remove();
+}
+
+// the --latency mode: the percentiles of the single operations.
+static void run_latencies(long long max_n) {
+	printf("structure,workload,n,ops,p50_ns,p99_ns,p999_ns,max_ns\n");
+	for (long long n = 1000; n <= max_n; n *= 10) {
+		run_latency<PairingHeap<int> >("PairingHeap", int(n));
+		run_latency<PairingHeap<int, less<int>, PH_PoolAlloc> >(
+				"PairingHeap/pool", int(n));
+		run_latency<
+				PairingHeap<int, less<int>, PH_PoolAlloc, PH_PointerLayout,
+						PH_AuxTwoPass> >("PairingHeap/pool/aux", int(n));
+		run_latency<
+				PairingHeap<int, less<int>, PH_PoolAlloc, PH_PointerLayout,
+						PH_Incremental<PH_TwoPass> > >(
+				"PairingHeap/pool/incremental", int(n));
+		run_latency<DaryHeap<int> >("DaryHeap", int(n));
+		run_latency<RankPairingHeap<int> >("RankPairingHeap", int(n));
+	}
+}
+
+static void run_std(int n, const Graph &grid, const Graph &road) {
+	const char *name = "std::priority_queue";
+	if (!strstr(name, filter))
+		return;
+	Workloads<StdPQ> w(name, n);
+	w.insert_delete();
+	w.sorted("sorted_asc", 1);
+	w.sorted("sorted_desc", -1);
+	w.adversarial();
+	w.hold();
+	dijkstra_lazy("dijkstra_grid", grid);
+	dijkstra_lazy("dijkstra_road", road);
+}
+
+int main(int argc, char **argv) {
+	bool latency = argc > 1 && strcmp(argv[1], "--latency") == 0;
+	if (latency) {
+		--argc;
+		++argv;
+	}
+	long long max_n = argc > 1 ? atoll(argv[1]) : 1000000;
+	if (argc > 2)
+		filter = argv[2];
+	if (latency) {
+		run_latencies(max_n);
+		fprintf(stderr, "checksum %lld\n", checksum);
+		return 0;
+	}
+	printf("structure,workload,n,ops,ns_per_op,mops_per_s\n");
+	for (long long n = 1000; n <= max_n; n *= 10) {
+		Rng rng(n);
+		Graph grid = grid_graph(int(n), rng), road = road_graph(int(n), rng);
+		run_addressable<PairingHeap<int> >("PairingHeap", int(n), grid, road);
+		run_addressable<PairingHeap<int, less<int>, PH_PoolAlloc> >(
+				"PairingHeap/pool", int(n), grid, road);
+		run_addressable<
+				PairingHeap<int, less<int>, PH_NewAlloc, PH_IndexLayout> >(
+				"PairingHeap/index", int(n), grid, road);
+		run_addressable<
+				PairingHeap<int, less<int>, PH_PoolAlloc, PH_PointerLayout,
+						PH_AuxTwoPass> >("PairingHeap/pool/aux", int(n), grid,
+				road);
+		run_addressable<
+				PairingHeap<int, less<int>, PH_PoolAlloc, PH_PointerLayout,
+						PH_Incremental<PH_TwoPass> > >(
+				"PairingHeap/pool/incremental", int(n), grid, road);
+		run_addressable<
+				PairingHeap<int, less<int>, PH_PoolAlloc, PH_PointerLayout,
+						PH_MultiPass> >("PairingHeap/pool/multipass", int(n),
+				grid, road);
+		run_addressable<
+				PairingHeap<int, less<int>, PH_PoolAlloc, PH_PointerLayout,
+						PH_Prefetching<PH_TwoPass> > >(
+				"PairingHeap/pool/prefetch", int(n), grid, road);
+		run_addressable<DaryHeap<int> >("DaryHeap", int(n), grid, road);
+		run_addressable<DaryHeap<int, less<int>, 8> >("DaryHeap/8", int(n), grid,
+				road);
+		run_addressable<RankPairingHeap<int> >("RankPairingHeap", int(n), grid,
+				road);
+		run_monotone<RadixHeap<int> >("RadixHeap", int(n), grid, road);
+		hold_payload<PairingHeap<Job, JobLess> >("PairingHeap", int(n));
+		hold_payload<SplitPairingHeap<Job, DueOf> >("SplitPairingHeap",
+				int(n));
+		timers<TimerQueue<int, PH_PoolAlloc> >("TimerQueue/pool", int(n));
+		timers<DeleteMinTimers>("PairingHeap/pool", int(n));
+		run_std(int(n), grid, road);
+		run_concurrent(int(n));
+	}
+	fprintf(stderr, "checksum %lld\n", checksum);
+	return 0;
+}
@@ -0,0 +1,80 @@
+//============================================================================
+// Name        : RadixHeap.cpp
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : Test program for RadixHeap.h
+//============================================================================
+
+#include "RadixHeap.h"
+#include <iostream>
+#include <set>
+#include <cstdlib>
+#include <ctime>
+using namespace std;
+
+const int mn = 10000;
+
+// find_min is a read: it must not move the lower bound of the keys.
+bool find_min_keeps_bound() {
+	RadixHeap<int> pq;
+	int bound = pq.last_min();
+	pq.insert(0, 10);
+	if (pq.find_min().id != 0 || pq.last_min() != bound)
+		return 0;
+	try {
+		pq.insert(1, 5);
+		pq.decrease_key(0, 3);
+	} catch (exception &e) {
+		cout << e.what() << endl;
+		return 0;
+	}
+	return pq.find_min().id == 0 && pq.delete_min().key == 3
+			&& pq.last_min() == 3 && pq.find_min().key == 5;
+}
+
+// random operations with monotone keys, against a std::set of (key, id).
+template<typename T>
+bool model(int ops) {
+	RadixHeap<T> pq(mn);
+	set<pair<T, int> > ref;
+	T last = pq.last_min();
+	for (int i = 0; i < ops; ++i) {
+		int id = rand() % mn, op = rand() % 6;
+		T k = T(last + rand() % 1000);
+		if (op < 2) {
+			bool had = pq.contains(id);
+			if (pq.try_insert(id, k) == had)
+				return 0;
+			if (!had)
+				ref.insert(make_pair(k, id));
+		} else if (op == 2 && !ref.empty()) {
+			if (pq.find_min().key != ref.begin()->first)
+				return 0;
+			typename RadixHeap<T>::Element e = pq.delete_min();
+			if (e.key != ref.begin()->first)
+				return 0;
+			ref.erase(make_pair(e.key, e.id));
+			last = e.key;
+		} else if (op == 3 && pq.contains(id)) {
+			ref.erase(make_pair(pq.get_key(id), id));
+			T nk = T(last + rand() % 1000);
+			pq.update_key(id, nk);
+			ref.insert(make_pair(nk, id));
+		} else if (op == 4 && pq.contains(id)) {
+			ref.erase(make_pair(pq.get_key(id), id));
+			pq.remove(id);
+		} else if (!ref.empty() && pq.find_min().key != ref.begin()->first)
+			return 0;
+		if (pq.size() != ref.size() || pq.last_min() != last)
+			return 0;
+	}
+	return 1;
+}
+
+int main() {
+	srand(time(0));
+	cout << "find_min keeps the bound: " << find_min_keeps_bound() << endl;
+	cout << "int: " << model<int>(1000000) << endl;
+	cout << "unsigned: " << model<unsigned>(1000000) << endl;
+	return 0;
+}
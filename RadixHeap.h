@@ -0,0 +1,400 @@
+//============================================================================
+// Name        : RadixHeap.h
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : addressable radix heaps for monotone integer keys
+//============================================================================
+
+#ifndef RADIXHEAP_H_
+#define RADIXHEAP_H_
+
+#include "PairingHeap.h"
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+/**
+ * The class of addressable radix heaps, a monotone priority queue for integer keys.
+ * It has the interface of @PairingHeap, with the same id's and exceptions,
+ * but no key may ever be smaller than the last deleted minimum (e.g. the distances in Dijkstra's algorithm).
+ * Inserting or changing a key to a smaller one throws an exception, which also checks that invariant.
+ *
+ * Algo:
+ * 		Let last be the last deleted minimum (or the smallest value of T at the start).
+ * 		An element with key k is kept in bucket 0 if k == last, and otherwise in bucket i,
+ * 		where i is the number of the highest bit in which k and last differ (counted from 1).
+ * 		The buckets are intrusive doubly linked lists through a node array indexed by id,
+ * 		so insert, remove and changing a key just link and unlink in O(1) time.
+ * 		delete_min takes from bucket 0. If it's empty, the first non-empty bucket is scanned for its minimum,
+ * 		which becomes last, and its elements are redistributed to the lower buckets.
+ * 		An element only moves down, so this takes O(logC) amortized time, where C is the range of the keys.
+ * 		find_min only scans that bucket for its minimum, which is cached until the next change,
+ * 		so it doesn't move the lower bound of the keys.
+ *
+ * Template parameters:
+ * 		typename T:
+ * 			an integral type of the keys, signed or unsigned. They are ordered as usual; there's no comparator.
+ *
+ * Public methods:
+ * 		all methods of @PairingHeap except meld, stats, peek_k, extract_k and the *_unchecked ones, and:
+ * 		T last_min():
+ * 			returns the last deleted minimum, the lower bound of all keys.
+ * Time:
+ * 		Insert, remove, decrease_key, increase_key and update_key take constant time.
+ * 		Delete_min takes O(logC) amortized time.
+ */
+template<typename T = int>
+class RadixHeap {
+	static_assert(std::is_integral<T>::value, "RadixHeap needs integral keys");
+	// the keys as unsigned integers in the same order.
+	typedef typename std::make_unsigned<T>::type U;
+	static const int BITS = std::numeric_limits<U>::digits;
+public:
+	/**
+	 * The representation of an element: a pair (id, key).
+	 */
+	struct Element {
+		int id;
+		T key;
+		Element() :
+				id(-1), key() {
+		}
+		Element(int id, T key) :
+				id(id), key(key) {
+		}
+	};
+private:
+	/**
+	 * The slot of an id: its element and its links in the list of its bucket.
+	 * The element is kept whole, so that find_min can return a reference to it.
+	 */
+	struct Slot {
+		Element elem;
+		// the neighbours in the bucket, -1 if none.
+		int prev, next;
+		// the bucket, or -1 if there's no element with this id.
+		int bucket;
+		Slot() :
+				prev(-1), next(-1), bucket(-1) {
+		}
+	};
+
+	// the current size and the maximal size. Valid id's are in [0, maxsz).
+	int sz, maxsz;
+	// the last deleted minimum.
+	U last;
+	// the map from the id's to the slots. It grows on demand if no maximal size is given.
+	std::vector<Slot> slots;
+	// the first element of each bucket, -1 if it's empty.
+	int head[BITS + 1];
+	// the id of the minimum found by find_min, or -1 if it has to be found again.
+	mutable int min_id;
+
+	// the possible exceptions. (initialized below out of the class)
+	static const PH_Exception PH_EX_EMPTY, PH_EX_BAD_ID, PH_EX_ALREADY_EXISTS,
+			PH_EX_NO_SUCH_ELEMENT, PH_EX_NOT_MONOTONE;
+
+	// converts between the keys and their order preserving unsigned form.
+	static U to_u(T k) {
+		return std::is_signed<T>::value ? U(k) ^ (U(1) << (BITS - 1)) : U(k);
+	}
+	static T from_u(U k) {
+		return std::is_signed<T>::value ? T(k ^ (U(1) << (BITS - 1))) : T(k);
+	}
+	// the key of the element id in the unsigned form.
+	U ukey(int id) const {
+		return to_u(slots[id].elem.key);
+	}
+	// the bucket of key k.
+	int bucket_of(U k) const {
+		U x = k ^ last;
+#if defined(__GNUC__)
+		return x ? std::numeric_limits<unsigned long long>::digits
+						- __builtin_clzll(x) : 0;
+#else
+		int b = 0;
+		while (x) {
+			x >>= 1;
+			++b;
+		}
+		return b;
+#endif
+	}
+	// ensures id is valid and there's NO element with this id.
+	void ensure_not_existing(int id) const {
+		if (id < 0 || id >= maxsz)
+			throw PH_EX_BAD_ID;
+		if (contains(id))
+			throw PH_EX_ALREADY_EXISTS;
+	}
+	// ensures id is valid and there's ONE element with this id.
+	void ensure_existing(int id) const {
+		if (id < 0 || id >= maxsz)
+			throw PH_EX_BAD_ID;
+		if (!contains(id))
+			throw PH_EX_NO_SUCH_ELEMENT;
+	}
+	// ensures the heap is non-empty
+	void ensure_nonempty() const {
+		if (sz == 0)
+			throw PH_EX_EMPTY;
+	}
+	// ensures key isn't smaller than the last minimum.
+	void ensure_monotone(T key) const {
+		if (to_u(key) < last)
+			throw PH_EX_NOT_MONOTONE;
+	}
+	// puts id with the given key into its bucket.
+	void link(int id, U key) {
+		min_id = -1;
+		Slot &s = slots[id];
+		int b = bucket_of(key);
+		s.elem = Element(id, from_u(key));
+		s.bucket = b;
+		s.prev = -1;
+		s.next = head[b];
+		if (head[b] >= 0)
+			slots[head[b]].prev = id;
+		head[b] = id;
+	}
+	// takes id out of its bucket.
+	void unlink(int id) {
+		min_id = -1;
+		Slot &s = slots[id];
+		if (s.prev >= 0)
+			slots[s.prev].next = s.next;
+		else
+			head[s.bucket] = s.next;
+		if (s.next >= 0)
+			slots[s.next].prev = s.prev;
+		s.bucket = -1;
+	}
+	/**
+	 * makes bucket 0 non-empty, if the heap isn't empty.
+	 * Algo:
+	 * 		find the minimum of the first non-empty bucket, make it the last minimum,
+	 * 		and redistribute the elements of that bucket.
+	 */
+	void settle() {
+		if (head[0] >= 0 || sz == 0)
+			return;
+		int b = 1;
+		while (head[b] < 0)
+			++b;
+		U m = std::numeric_limits<U>::max();
+		for (int x = head[b]; x >= 0; x = slots[x].next)
+			m = std::min(m, ukey(x));
+		last = m;
+		int x = head[b];
+		head[b] = -1;
+		while (x >= 0) {
+			int next = slots[x].next;
+			link(x, ukey(x));
+			x = next;
+		}
+	}
+	// changes the key of the element id to the checked key.
+	void change(int id, T key) {
+		unlink(id);
+		link(id, to_u(key));
+	}
+public:
+	RadixHeap() :
+			sz(0), maxsz(INT_MAX), last(0), min_id(-1) {
+		std::fill(head, head + BITS + 1, -1);
+	}
+	RadixHeap(int max_size) :
+			sz(0), maxsz(max_size), last(0), slots(max_size), min_id(-1) {
+		std::fill(head, head + BITS + 1, -1);
+	}
+	/**
+	 * removes all elements, keeping the allocated space for reuse.
+	 * The lower bound of the keys is reset, too.
+	 */
+	void clear() {
+		for (int b = 0; b <= BITS; ++b)
+			for (int x = head[b]; x >= 0; x = slots[x].next)
+				slots[x].bucket = -1;
+		std::fill(head, head + BITS + 1, -1);
+		sz = 0;
+		last = 0;
+		min_id = -1;
+	}
+	size_t size() const {
+		return sz;
+	}
+	size_t max_size() const {
+		return maxsz;
+	}
+	bool contains(int id) const {
+		return id >= 0 && size_t(id) < slots.size() && slots[id].bucket >= 0;
+	}
+	/**
+	 * returns the last deleted minimum. No key may be smaller than it.
+	 */
+	T last_min() const {
+		return from_u(last);
+	}
+	/**
+	 * returns the current minimal element in the priority queue.
+	 * The reference is valid until the next change of the pq.
+	 * Throws an exception if the pq is empty.
+	 * Unlike delete_min, it doesn't change the last minimum.
+	 * The id of the minimum is cached until the next change, which even this const call writes,
+	 * so concurrent find_min's on the same pq aren't safe without a lock.
+	 */
+	const Element &find_min() const {
+		ensure_nonempty();
+		if (min_id < 0) {
+			int b = 0;
+			while (head[b] < 0)
+				++b;
+			min_id = head[b];
+			for (int x = slots[min_id].next; x >= 0; x = slots[x].next)
+				if (ukey(x) < ukey(min_id))
+					min_id = x;
+		}
+		return slots[min_id].elem;
+	}
+	T get_key(int id) const {
+		ensure_existing(id);
+		return slots[id].elem.key;
+	}
+	/**
+	 * try to insert an element with the given id and key.
+	 * Throws an exception if the id is invalid, there's already an element with that id,
+	 * or the key is smaller than the last minimum.
+	 */
+	void insert(int id, T key) {
+		ensure_not_existing(id);
+		ensure_monotone(key);
+		if (size_t(id) >= slots.size())
+			slots.resize(std::max(size_t(id) + 1, 2 * slots.size()));
+		link(id, to_u(key));
+		++sz;
+	}
+	template<typename It>
+	void insert_bulk(It first, It last) {
+		for (It it = first; it != last; ++it) {
+			ensure_not_existing(it->first);
+			ensure_monotone(it->second);
+		}
+		It it = first;
+		try {
+			for (; it != last; ++it)
+				insert(it->first, it->second);
+		} catch (...) {
+			for (; first != it; ++first)
+				remove(first->first);
+			throw;
+		}
+	}
+	Element delete_min() {
+		ensure_nonempty();
+		settle();
+		int id = head[0];
+		unlink(id);
+		--sz;
+		return Element(id, from_u(last));
+	}
+	template<typename OutIt>
+	OutIt drain_sorted(OutIt out) {
+		while (sz) {
+			*out = delete_min();
+			++out;
+		}
+		return out;
+	}
+	Element remove(int id) {
+		ensure_existing(id);
+		unlink(id);
+		--sz;
+		return slots[id].elem;
+	}
+	/**
+	 * try to decrease the key of the element with the given id.
+	 * It does nothing if newkey is larger than the current key of the element.
+	 * Throws an exception if newkey is smaller than the last minimum.
+	 */
+	void decrease_key(int id, T newkey) {
+		ensure_existing(id);
+		ensure_monotone(newkey);
+		if (to_u(newkey) < ukey(id))
+			change(id, newkey);
+	}
+	template<typename It>
+	void decrease_key_batch(It first, It last) {
+		for (It it = first; it != last; ++it) {
+			ensure_existing(it->first);
+			ensure_monotone(it->second);
+		}
+		for (; first != last; ++first)
+			decrease_key(first->first, first->second);
+	}
+	/**
+	 * try to increase the key of the element with the given id.
+	 * It does nothing if newkey is smaller than the current key of the element.
+	 */
+	void increase_key(int id, T newkey) {
+		ensure_existing(id);
+		if (ukey(id) < to_u(newkey))
+			change(id, newkey);
+	}
+	/**
+	 * changes the key of the element with the given id to newkey.
+	 * Throws an exception if newkey is smaller than the last minimum.
+	 */
+	void update_key(int id, T newkey) {
+		ensure_existing(id);
+		ensure_monotone(newkey);
+		change(id, newkey);
+	}
+	bool try_insert(int id, T key) {
+		if (id < 0 || id >= maxsz || contains(id) || to_u(key) < last)
+			return false;
+		insert(id, key);
+		return true;
+	}
+	bool try_delete_min(Element &min) {
+		if (sz == 0)
+			return false;
+		min = delete_min();
+		return true;
+	}
+	/**
+	 * calls fn(elem) for every element in the pq, in no particular order.
+	 */
+	template<typename F>
+	void for_each(F fn) const {
+		for (int b = 0; b <= BITS; ++b)
+			for (int x = head[b]; x >= 0; x = slots[x].next)
+				fn(slots[x].elem);
+	}
+	/**
+	 * starts to load the slot of the given id into the cache.
+	 * It does nothing if the id is invalid.
+	 */
+	void prefetch(int id) const {
+		if (id >= 0 && size_t(id) < slots.size())
+			PH_PREFETCH(&slots[id]);
+	}
+};
+
+/**
+ * The following are possible exceptions.
+ */
+template<typename T>
+const PH_Exception RadixHeap<T>::PH_EX_ALREADY_EXISTS(
+		"An element with the same ID already exists.");
+template<typename T>
+const PH_Exception RadixHeap<T>::PH_EX_EMPTY("The heap is empty!");
+template<typename T>
+const PH_Exception RadixHeap<T>::PH_EX_BAD_ID("ID out of range!");
+template<typename T>
+const PH_Exception RadixHeap<T>::PH_EX_NO_SUCH_ELEMENT(
+		"The heap contains no element with this ID!");
+template<typename T>
+const PH_Exception RadixHeap<T>::PH_EX_NOT_MONOTONE(
+		"The key is smaller than the last minimum!");
+
+#endif /* RADIXHEAP_H_ */
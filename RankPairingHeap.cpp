@@ -0,0 +1,127 @@
+//============================================================================
+// Name        : RankPairingHeap.cpp
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : Test program for RankPairingHeap.h
+//============================================================================
+
+#include "RankPairingHeap.h"
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+using namespace std;
+
+const int mn = 1000;
+
+template<typename T> T make_key(int v);
+template<> int make_key<int>(int v) {
+	return v;
+}
+template<> string make_key<string>(int v) {
+	char s[16];
+	sprintf(s, "%08d", v + 50000000);
+	return s;
+}
+
+/**
+ * random operations against a std::set of (key, id), with many decrease_key's.
+ * Keys are kept as ints in the set, negated for a comparator that reverses the order.
+ */
+template<typename T, typename Comparator>
+bool model(int ops) {
+	typedef RankPairingHeap<T, Comparator> H;
+	H pq(mn);
+	set<pair<int, int> > ref;
+	vector<int> key(mn);
+	int sign = Comparator()(make_key<T>(0), make_key<T>(1)) ? 1 : -1;
+	for (int i = 0; i < ops; ++i) {
+		int id = rand() % mn, op = rand() % 10, k = rand() % 100000;
+		bool has = pq.contains(id);
+		if (op < 2) {
+			if (pq.try_insert(id, make_key<T>(k)) == has)
+				return 0;
+			if (!has)
+				ref.insert(make_pair(sign * (key[id] = k), id));
+		} else if (op == 2 && !ref.empty()) {
+			typename H::Element e = pq.delete_min();
+			if (make_key<T>(sign * ref.begin()->first) != e.key)
+				return 0;
+			ref.erase(make_pair(ref.begin()->first, e.id));
+		} else if (op < 6 && has) {
+			// a smaller key in the order of the comparator.
+			int nk = key[id] - sign * (rand() % 1000);
+			ref.erase(make_pair(sign * key[id], id));
+			pq.decrease_key(id, make_key<T>(nk));
+			ref.insert(make_pair(sign * (key[id] = nk), id));
+		} else if (op == 6 && has) {
+			int nk = key[id] + sign * (rand() % 1000);
+			ref.erase(make_pair(sign * key[id], id));
+			pq.increase_key(id, make_key<T>(nk));
+			ref.insert(make_pair(sign * (key[id] = nk), id));
+		} else if (op == 7 && has) {
+			ref.erase(make_pair(sign * key[id], id));
+			pq.update_key(id, make_key<T>(k));
+			ref.insert(make_pair(sign * (key[id] = k), id));
+		} else if (op == 8 && has) {
+			if (pq.remove(id).key != make_key<T>(key[id]))
+				return 0;
+			ref.erase(make_pair(sign * key[id], id));
+		} else if (!ref.empty()
+				&& (pq.find_min().key != make_key<T>(sign * ref.begin()->first)
+						|| (has && pq.get_key(id) != make_key<T>(key[id]))))
+			return 0;
+		if (pq.size() != ref.size())
+			return 0;
+	}
+	vector<typename H::Element> out;
+	pq.drain_sorted(back_inserter(out));
+	for (size_t i = 0; i < out.size(); ++i) {
+		if (out[i].key != make_key<T>(sign * ref.begin()->first))
+			return 0;
+		ref.erase(make_pair(ref.begin()->first, out[i].id));
+	}
+	return ref.empty() && pq.size() == 0;
+}
+
+// a bulk with a repeated id is rejected as a whole, and one without is inserted.
+bool bulk() {
+	RankPairingHeap<int> pq;
+	vector<pair<int, int> > b;
+	for (int i = 0; i < 100; ++i)
+		b.push_back(make_pair(i * 3, 1000 - i));
+	pq.insert(500, 5);
+	b.push_back(make_pair(7, 1));
+	b.push_back(make_pair(7, 2));
+	try {
+		pq.insert_bulk(b.begin(), b.end());
+		return 0;
+	} catch (PH_Exception &) {
+	}
+	if (pq.size() != 1 || pq.contains(0) || pq.find_min().id != 500)
+		return 0;
+	b.pop_back();
+	pq.insert_bulk(b.begin(), b.end());
+	if (pq.size() != 102 || pq.delete_min().key != 1 || pq.delete_min().key != 5)
+		return 0;
+	for (int last = 0; pq.size() > 0;) {
+		int k = pq.delete_min().key;
+		if (k < last)
+			return 0;
+		last = k;
+	}
+	return 1;
+}
+
+int main() {
+	srand(time(0));
+	cout << "bulk: " << bulk() << endl;
+	cout << "int: " << model<int, less<int> >(500000) << endl;
+	cout << "int greater: " << model<int, greater<int> >(500000) << endl;
+	cout << "string: " << model<string, less<string> >(200000) << endl;
+	return 0;
+}
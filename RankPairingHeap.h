@@ -0,0 +1,451 @@
+//============================================================================
+// Name        : RankPairingHeap.h
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : addressable rank-pairing heaps with the interface of PairingHeap
+//============================================================================
+
+#ifndef RANKPAIRINGHEAP_H_
+#define RANKPAIRINGHEAP_H_
+
+#include "PairingHeap.h"
+#include <vector>
+
+/**
+ * The class of addressable rank-pairing heaps (type 1, Haeupler, Sen and Tarjan).
+ * It has the same interface as @PairingHeap, with the same id's and exceptions,
+ * so that the two can be swapped without touching the call sites.
+ * Unlike a pairing heap, decrease_key takes O(1) amortized time, which pays off when it dominates,
+ * e.g. Dijkstra's or Prim's algorithm on dense graphs. Its delete_min is slower, though,
+ * so on sparse graphs a @PairingHeap or a @DaryHeap is usually faster.
+ *
+ * Algo:
+ * 		The heap is a list of half-trees: binary trees whose roots have only a left child,
+ * 		in which every node is not larger than all nodes in its left subtree.
+ * 		Each node has a rank. A root has the rank of its left child plus 1. Any other node has
+ * 		the rank of its children plus 1 if they're equal, and the larger one otherwise (a missing child has rank -1).
+ * 		Insert adds a root of rank 0. Linking two roots of the same rank r makes the larger one the left child
+ * 		of the smaller one, whose old left subtree becomes the right one of the loser, and gives the winner rank r+1.
+ * 		Delete_min makes the right spine of the left child of the minimum roots, and links the roots in one pass:
+ * 		each one goes into the bucket of its rank, and two roots meeting there are linked and leave the buckets.
+ * 		Decrease_key cuts the node with its left subtree, lets its right subtree take its place, makes it a root,
+ * 		and lowers the ranks of its ancestors by the rule above, stopping where a rank doesn't change.
+ * 		The roots are kept in a circular doubly linked list, and the nodes in an array indexed by id.
+ *
+ * Template parameters:
+ * 		typename T:
+ * 			the type of the keys.
+ * 		typename Comparator:
+ * 			the same as in @PairingHeap.
+ *
+ * Public methods:
+ * 		all methods of @PairingHeap except meld, stats, peek_k, extract_k and the *_unchecked ones.
+ * Time:
+ * 		Insert and decrease_key take O(1) amortized time, delete_min, remove and increase_key O(logn) amortized time.
+ * 		Find_min, get_key and contains take constant time. Clear takes time linear in the largest id in use.
+ */
+template<typename T, typename Comparator = std::less<T> >
+class RankPairingHeap {
+public:
+	/**
+	 * The representation of an element: a pair (id, key).
+	 */
+	struct Element {
+		int id;
+		T key;
+		Element() :
+				id(-1), key() {
+		}
+		template<typename ... Args>
+		Element(int id, Args&&... args) :
+				id(id), key(std::forward<Args>(args)...) {
+		}
+	};
+private:
+	/**
+	 * The node of the element with the same id as its index.
+	 * The element is kept whole, so that find_min can return a reference to it.
+	 * The right link of a root is the next root in the list, and prev the previous one.
+	 * rank is -1 iff there's no element with this id.
+	 */
+	struct Slot {
+		Element elem;
+		int left, right, parent, prev, rank;
+		Slot() :
+				left(-1), right(-1), parent(-1), prev(-1), rank(-1) {
+		}
+	};
+
+	// the current and maximal size. Valid id's are in [0, maxsz).
+	size_t sz;
+	int maxsz;
+	Comparator less;
+	// the nodes by id. It grows on demand if no maximal size is given.
+	std::vector<Slot> slots;
+	// the minimal root, or -1 if the pq is empty.
+	int minr;
+	// the roots being linked by delete_min, and the bucket of each rank. Kept for reuse.
+	std::vector<int> pending, bucket;
+
+	// the possible exceptions. (initialized below out of the class)
+	static const PH_Exception PH_EX_EMPTY, PH_EX_BAD_ID, PH_EX_ALREADY_EXISTS,
+			PH_EX_NO_SUCH_ELEMENT;
+
+	// ensures id is valid and there's NO element with this id.
+	void ensure_not_existing(int id) const {
+		if (id < 0 || id >= maxsz)
+			throw PH_EX_BAD_ID;
+		if (contains(id))
+			throw PH_EX_ALREADY_EXISTS;
+	}
+	// ensures id is valid and there's ONE element with this id.
+	void ensure_existing(int id) const {
+		if (id < 0 || id >= maxsz)
+			throw PH_EX_BAD_ID;
+		if (!contains(id))
+			throw PH_EX_NO_SUCH_ELEMENT;
+	}
+	// ensures the heap is non-empty
+	void ensure_nonempty() const {
+		if (sz == 0)
+			throw PH_EX_EMPTY;
+	}
+	// makes slots cover id.
+	void cover(int id) {
+		if (size_t(id) >= slots.size())
+			slots.resize(std::max(size_t(id) + 1, 2 * slots.size()));
+	}
+	// the rank of the node x, or -1 if x is -1.
+	int rank_of(int x) const {
+		return x < 0 ? -1 : slots[x].rank;
+	}
+	// whether the key of x is less than that of y.
+	bool before(int x, int y) {
+		return less(slots[x].elem.key, slots[y].elem.key);
+	}
+	// puts x into the list of roots. It's the new minimum if it's as small as the current one.
+	void add_root(int x) {
+		Slot &s = slots[x];
+		s.parent = -1;
+		if (minr < 0) {
+			s.right = s.prev = minr = x;
+			return;
+		}
+		s.prev = minr;
+		s.right = slots[minr].right;
+		slots[s.right].prev = x;
+		slots[minr].right = x;
+		if (!before(minr, x))
+			minr = x;
+	}
+	// links the roots x and y of the same rank, and returns the winner, which goes up a rank.
+	int join(int x, int y) {
+		if (before(y, x))
+			std::swap(x, y);
+		Slot &w = slots[x], &l = slots[y];
+		l.right = w.left;
+		if (w.left >= 0)
+			slots[w.left].parent = y;
+		w.left = y;
+		l.parent = x;
+		++w.rank;
+		return x;
+	}
+	/**
+	 * links the roots in one pass and finds the new minimum.
+	 * A root joins the bucket of its rank. If there's already one, the two are linked
+	 * and the result goes back into the list, so that each root is linked at most once.
+	 */
+	void link_roots() {
+		pending.clear();
+		int r = minr;
+		do {
+			pending.push_back(r);
+			r = slots[r].right;
+		} while (r != minr);
+		minr = -1;
+		for (size_t i = 0; i < pending.size(); ++i) {
+			int x = pending[i];
+			size_t k = slots[x].rank;
+			if (k >= bucket.size())
+				bucket.resize(k + 1, -1);
+			if (bucket[k] < 0)
+				bucket[k] = x;
+			else {
+				int y = bucket[k];
+				bucket[k] = -1;
+				add_root(join(x, y));
+			}
+		}
+		for (size_t k = 0; k < bucket.size(); ++k)
+			if (bucket[k] >= 0) {
+				add_root(bucket[k]);
+				bucket[k] = -1;
+			}
+	}
+	/**
+	 * makes the non-root x a root, with its left subtree. Its right subtree takes its place.
+	 * Then the ranks of the ancestors are lowered by the rank rule, as long as they change.
+	 */
+	void cut(int x) {
+		Slot &s = slots[x];
+		int y = s.parent, z = s.right;
+		if (slots[y].left == x)
+			slots[y].left = z;
+		else
+			slots[y].right = z;
+		if (z >= 0)
+			slots[z].parent = y;
+		s.rank = rank_of(s.left) + 1;
+		add_root(x);
+		for (;;) {
+			Slot &t = slots[y];
+			if (t.parent < 0) {
+				t.rank = rank_of(t.left) + 1;
+				break;
+			}
+			int rl = rank_of(t.left), rr = rank_of(t.right);
+			int k = rl == rr ? rl + 1 : std::max(rl, rr);
+			if (k >= t.rank)
+				break;
+			t.rank = k;
+			y = t.parent;
+		}
+	}
+	/**
+	 * takes x out of the half-trees, leaving a node without links.
+	 * A non-root is cut first. The right spine of its left child become roots,
+	 * and the roots are linked if x was the minimum.
+	 */
+	void detach(int x) {
+		if (slots[x].parent >= 0)
+			cut(x);
+		Slot &s = slots[x];
+		bool was_min = x == minr;
+		if (s.right == x)
+			minr = -1;
+		else {
+			slots[s.prev].right = s.right;
+			slots[s.right].prev = s.prev;
+			if (was_min)
+				minr = s.right;
+		}
+		for (int c = s.left; c >= 0;) {
+			int next = slots[c].right;
+			slots[c].rank = rank_of(slots[c].left) + 1;
+			add_root(c);
+			c = next;
+		}
+		s.left = s.right = s.prev = -1;
+		if (was_min && minr >= 0)
+			link_roots();
+	}
+	// removes x and returns its element.
+	Element take(int x) {
+		detach(x);
+		Slot &s = slots[x];
+		Element r(x, std::move(s.elem.key));
+		s.rank = -1;
+		--sz;
+		return r;
+	}
+	// adds a new element as a root of rank 0.
+	template<typename ... Args>
+	void add(int id, Args&&... args) {
+		cover(id);
+		Slot &s = slots[id];
+		s.elem.id = id;
+		s.elem.key = T(std::forward<Args>(args)...);
+		s.left = -1;
+		s.rank = 0;
+		add_root(id);
+		++sz;
+	}
+public:
+	RankPairingHeap() :
+			sz(0), maxsz(INT_MAX), minr(-1) {
+	}
+	RankPairingHeap(int max_size) :
+			sz(0), maxsz(max_size), slots(max_size), minr(-1) {
+	}
+	/**
+	 * removes all elements, keeping the allocated space for reuse.
+	 */
+	void clear() {
+		for (size_t i = 0; i < slots.size() && sz > 0; ++i)
+			if (slots[i].rank >= 0) {
+				slots[i] = Slot();
+				--sz;
+			}
+		minr = -1;
+	}
+	size_t size() const {
+		return sz;
+	}
+	size_t max_size() const {
+		return maxsz;
+	}
+	bool contains(int id) const {
+		return id >= 0 && size_t(id) < slots.size() && slots[id].rank >= 0;
+	}
+	/**
+	 * returns the current minimal element in the priority queue.
+	 * The reference is valid until the next change of the pq.
+	 * Throws an exception if the pq is empty.
+	 */
+	const Element &find_min() const {
+		ensure_nonempty();
+		return slots[minr].elem;
+	}
+	/**
+	 * returns the current key of the element with the given id.
+	 * Throws an exception if the id is invalid or there's no element with that id.
+	 */
+	const T &get_key(int id) const {
+		ensure_existing(id);
+		return slots[id].elem.key;
+	}
+	void insert(int id, const T& key) {
+		emplace(id, key);
+	}
+	void insert(int id, T&& key) {
+		emplace(id, std::move(key));
+	}
+	template<typename ... Args>
+	void emplace(int id, Args&&... args) {
+		ensure_not_existing(id);
+		add(id, std::forward<Args>(args)...);
+	}
+	/**
+	 * inserts all elements in the range [first, last) of (id, key) pairs.
+	 * Throws an exception if some id is invalid or used twice, and then no element is inserted.
+	 * Algo:
+	 * 		validate all id's, then add them as roots in O(k) time.
+	 */
+	template<typename It>
+	void insert_bulk(It first, It last) {
+		for (It it = first; it != last; ++it)
+			ensure_not_existing(it->first);
+		It it = first;
+		try {
+			for (; it != last; ++it) {
+				if (contains(it->first))
+					throw PH_EX_ALREADY_EXISTS;
+				add(it->first, it->second);
+			}
+		} catch (...) {
+			for (; first != it; ++first)
+				take(first->first);
+			throw;
+		}
+	}
+	Element delete_min() {
+		ensure_nonempty();
+		return take(minr);
+	}
+	/**
+	 * removes all elements and writes them to out in sorted order.
+	 */
+	template<typename OutIt>
+	OutIt drain_sorted(OutIt out) {
+		while (sz > 0) {
+			*out = take(minr);
+			++out;
+		}
+		return out;
+	}
+	Element remove(int id) {
+		ensure_existing(id);
+		return take(id);
+	}
+	/**
+	 * try to decrease the key of the element with the given id.
+	 * It does nothing if newkey is larger than the current key of the element.
+	 * If the new key is as small as the minimum, that element will be the new minimum.
+	 */
+	void decrease_key(int id, const T& newkey) {
+		ensure_existing(id);
+		if (less(slots[id].elem.key, newkey))
+			return;
+		slots[id].elem.key = newkey;
+		if (slots[id].parent >= 0)
+			cut(id);
+		else if (!before(minr, id))
+			minr = id;
+	}
+	template<typename It>
+	void decrease_key_batch(It first, It last) {
+		for (It it = first; it != last; ++it)
+			ensure_existing(it->first);
+		for (; first != last; ++first)
+			decrease_key(first->first, first->second);
+	}
+	/**
+	 * try to increase the key of the element with the given id.
+	 * It does nothing if newkey is smaller than the current key of the element.
+	 * Algo:
+	 * 		take the node out like remove does, and add it back as a root of rank 0 with the new key.
+	 */
+	void increase_key(int id, const T& newkey) {
+		ensure_existing(id);
+		if (less(newkey, slots[id].elem.key))
+			return;
+		detach(id);
+		slots[id].elem.key = newkey;
+		slots[id].rank = 0;
+		add_root(id);
+	}
+	void update_key(int id, const T& newkey) {
+		ensure_existing(id);
+		if (less(slots[id].elem.key, newkey))
+			increase_key(id, newkey);
+		else
+			decrease_key(id, newkey);
+	}
+	bool try_insert(int id, const T& key) {
+		if (id < 0 || id >= maxsz || contains(id))
+			return false;
+		add(id, key);
+		return true;
+	}
+	bool try_delete_min(Element &min) {
+		if (sz == 0)
+			return false;
+		min = take(minr);
+		return true;
+	}
+	/**
+	 * calls fn(elem) for every element in the pq, in no particular order.
+	 */
+	template<typename F>
+	void for_each(F fn) const {
+		for (size_t i = 0; i < slots.size(); ++i)
+			if (slots[i].rank >= 0)
+				fn(slots[i].elem);
+	}
+	/**
+	 * starts to load the node of the element with the given id into the cache.
+	 * It does nothing if there's no element with that id.
+	 */
+	void prefetch(int id) const {
+		if (contains(id))
+			PH_PREFETCH(&slots[id]);
+	}
+};
+
+/**
+ * The following are possible exceptions.
+ */
+template<typename T, typename Comparator>
+const PH_Exception RankPairingHeap<T, Comparator>::PH_EX_ALREADY_EXISTS(
+		"An element with the same ID already exists.");
+template<typename T, typename Comparator>
+const PH_Exception RankPairingHeap<T, Comparator>::PH_EX_EMPTY(
+		"The heap is empty!");
+template<typename T, typename Comparator>
+const PH_Exception RankPairingHeap<T, Comparator>::PH_EX_BAD_ID("ID out of range!");
+template<typename T, typename Comparator>
+const PH_Exception RankPairingHeap<T, Comparator>::PH_EX_NO_SUCH_ELEMENT(
+		"The heap contains no element with this ID!");
+
+#endif /* RANKPAIRINGHEAP_H_ */
@@ -0,0 +1,142 @@
+//============================================================================
+// Name        : SplitPairingHeap.cpp
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : Test program for SplitPairingHeap.h
+//============================================================================
+
+#include "SplitPairingHeap.h"
+#include <iostream>
+#include <set>
+#include <vector>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+using namespace std;
+
+const int mn = 1000;
+
+/**
+ * a payload with a key and some data on the heap, counting its constructions and destructions.
+ * A leaked payload keeps made ahead of gone, and one destroyed twice puts gone ahead (and frees its data twice).
+ */
+struct Payload {
+	static long long made, gone;
+	int key;
+	vector<int> data;
+	Payload(int key) :
+			key(key), data(8, key) {
+		++made;
+	}
+	Payload(const Payload &o) :
+			key(o.key), data(o.data) {
+		++made;
+	}
+	Payload(Payload &&o) :
+			key(o.key), data(std::move(o.data)) {
+		++made;
+	}
+	Payload &operator=(const Payload &) = default;
+	Payload &operator=(Payload &&) = default;
+	~Payload() {
+		++gone;
+	}
+	// whether the data belongs to the key, i.e. it wasn't moved away or destroyed.
+	bool valid() const {
+		return data.size() == 8 && data[0] == key && data[7] == key;
+	}
+	static long long live() {
+		return made - gone;
+	}
+};
+long long Payload::made = 0, Payload::gone = 0;
+
+struct KeyOfPayload {
+	int operator()(const Payload &p) const {
+		return p.key;
+	}
+};
+
+/**
+ * random operations against a std::set of (key, id), checking after each that exactly the payloads
+ * in the heap are alive.
+ */
+template<typename H>
+bool model(int ops) {
+	H pq(mn);
+	set<pair<int, int> > ref;
+	vector<int> key(mn);
+	bool ok = 1;
+	for (int i = 0; i < ops && ok; ++i) {
+		int id = rand() % mn, k = rand() % 100000, op = rand() % 10;
+		bool has = pq.contains(id);
+		if (op < 3) {
+			try {
+				if (op == 0)
+					pq.insert(id, Payload(k));
+				else if (op == 1) {
+					Payload p(k);
+					pq.insert(id, p);
+				} else
+					pq.emplace(id, k);
+				ok = !has;
+				ref.insert(make_pair(key[id] = k, id));
+			} catch (PH_Exception &) {
+				ok = has;
+			}
+		} else if (op < 5 && !ref.empty()) {
+			typename H::Element e = pq.delete_min();
+			ok = e.payload.key == ref.begin()->first && e.payload.valid()
+					&& ref.erase(make_pair(e.payload.key, e.id));
+		} else if (op == 5 && has) {
+			typename H::Element e = pq.remove(id);
+			ok = e.id == id && e.payload.key == key[id] && e.payload.valid();
+			ref.erase(make_pair(key[id], id));
+		} else if (op < 8 && has) {
+			ref.erase(make_pair(key[id], id));
+			if (op == 6)
+				pq.update(id, Payload(k));
+			else
+				pq.modify(id, [k](Payload &p) {
+					p = Payload(k);
+				});
+			ref.insert(make_pair(key[id] = k, id));
+		} else if (op == 8 && rand() % 200 == 0) {
+			pq.clear();
+			ref.clear();
+		} else if (op == 9) {
+			size_t n = 0;
+			pq.for_each([&](int x, const Payload &p) {
+				ok = ok && p.key == key[x] && p.valid();
+				++n;
+			});
+			ok = ok && n == ref.size();
+		} else if (has)
+			ok = pq.get(id).key == key[id] && pq.get(id).valid() && pq.get_key(id) == key[id]
+					&& pq.get_key(pq.find_min()) == ref.begin()->first;
+		ok = ok && pq.size() == ref.size() && Payload::live() == (long long) ref.size();
+	}
+	return ok;
+}
+
+// the payloads left in a heap are destroyed with it.
+template<typename H>
+bool destroyed() {
+	{
+		H pq(mn);
+		for (int i = 0; i < mn; i += 3)
+			pq.emplace(i, rand() % 100000);
+		pq.delete_min();
+		pq.remove(3);
+	}
+	return Payload::live() == 0;
+}
+
+int main() {
+	srand(time(0));
+	typedef SplitPairingHeap<Payload, KeyOfPayload> H;
+	typedef SplitPairingHeap<Payload, KeyOfPayload, less<int>, PH_PoolAlloc, PH_IndexLayout, PH_AuxTwoPass> G;
+	cout << "two pass: " << model<H>(300000) << destroyed<H>() << endl;
+	cout << "index layout, pool, auxiliary: " << model<G>(300000) << destroyed<G>() << endl;
+	return 0;
+}
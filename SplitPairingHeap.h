@@ -0,0 +1,260 @@
+//============================================================================
+// Name        : SplitPairingHeap.h
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : pairing heaps keeping the keys apart from large payloads
+//============================================================================
+
+#ifndef SPLITPAIRINGHEAP_H_
+#define SPLITPAIRINGHEAP_H_
+
+#include "PairingHeap.h"
+#include <type_traits>
+#include <utility>
+
+/**
+ * The class of pairing heaps of large values, addressable with id's.
+ * A key extractor gets a small comparable key from each value (the payload).
+ * Only the key and the id are kept in the nodes of the tree, so merging and combining don't drag
+ * the payloads through the cache. The payloads live in a separate array indexed by id.
+ *
+ * Algo:
+ * 		A @PairingHeap of the keys does all the work.
+ * 		The payloads are constructed in place in pages of slots, which are allocated on first use
+ * 		and never moved, so a reference to a payload stays valid until its element is removed.
+ * 		A page is allocated as a whole for the first id in it, like PH_PagedLayout does.
+ *
+ * Template parameters:
+ * 		typename P:
+ * 			the type of the payloads.
+ * 		typename KeyOf:
+ * 			a function object with K operator()(const P&) const, which gives the key of a payload.
+ * 		typename Comparator, NodeAlloc, Layout, Variant, Stats:
+ * 			the same as in @PairingHeap, for the keys of type K.
+ *
+ * Public methods:
+ * 		SplitPairingHeap(int max_size), SplitPairingHeap():
+ * 			the same as in @PairingHeap.
+ * 		size, max_size, contains, clear, stats, prefetch:
+ * 			the same as in @PairingHeap.
+ *		void insert(int id, const P& payload), void insert(int id, P&& payload):
+ *			try to insert an element with the given id and payload.
+ *			Throws an exception if the id is invalid or there's already an element with that id.
+ *		void emplace(int id, Args&&... args):
+ *			like insert, but the payload is constructed in place from args.
+ *		int find_min():
+ *			returns the id of the element with the minimal key.
+ *			Throws an exception if the pq is empty.
+ *		const P& get(int id), const K& get_key(int id):
+ *			returns the payload (key) of the element with the given id.
+ *			Throws an exception if the id is invalid or there's no element with that id.
+ *		Element delete_min(), Element remove(int id):
+ *			removes and returns the element with the minimal key (the given id), with its payload moved out.
+ *		void update(int id, const P& payload), void update(int id, P&& payload):
+ *			replaces the payload of the element with the given id, and moves it by its new key.
+ *		void modify(int id, F fn):
+ *			calls fn(P&) on the payload of the element with the given id, and moves it by its new key.
+ *		void for_each(F fn):
+ *			calls fn(id, const P&) for every element, in no particular order.
+ */
+template<typename P, typename KeyOf, typename Comparator = std::less<
+		typename std::decay<
+				decltype(std::declval<KeyOf>()(std::declval<const P &>()))>::type>,
+		template<typename > class NodeAlloc = PH_NewAlloc,
+		typename Layout = PH_PointerLayout, typename Variant = PH_TwoPass,
+		typename Stats = PH_NoStats>
+class SplitPairingHeap {
+public:
+	typedef typename std::decay<decltype(std::declval<KeyOf>()(std::declval<const P &>()))>::type K;
+	typedef PairingHeap<K, Comparator, NodeAlloc, Layout, Variant, Stats> Heap;
+	/**
+	 * An element removed from the heap: its id and its payload.
+	 */
+	struct Element {
+		int id;
+		P payload;
+		Element(int id, P &&payload) :
+				id(id), payload(std::move(payload)) {
+		}
+	};
+private:
+	static const size_t PAGE_BITS = 10, PAGE_SIZE = size_t(1) << PAGE_BITS;
+	typedef typename std::aligned_storage<sizeof(P), alignof(P)>::type Raw;
+
+	// the keys and the id's.
+	Heap heap;
+	KeyOf key_of;
+	// the directory of the pages of payload slots. A page is 0 until an id in it is used.
+	Raw **dir;
+	size_t dirsz;
+
+	// the possible exceptions. (initialized below out of the class)
+	static const PH_Exception PH_EX_BAD_ID, PH_EX_ALREADY_EXISTS,
+			PH_EX_NO_SUCH_ELEMENT;
+
+	SplitPairingHeap(const SplitPairingHeap &) = delete;
+	SplitPairingHeap &operator=(const SplitPairingHeap &) = delete;
+
+	// ensures id is valid and there's NO element with this id.
+	void ensure_not_existing(int id) const {
+		if (id < 0 || size_t(id) >= max_size())
+			throw PH_EX_BAD_ID;
+		if (heap.contains(id))
+			throw PH_EX_ALREADY_EXISTS;
+	}
+	// ensures id is valid and there's ONE element with this id.
+	void ensure_existing(int id) const {
+		if (id < 0 || size_t(id) >= max_size())
+			throw PH_EX_BAD_ID;
+		if (!heap.contains(id))
+			throw PH_EX_NO_SUCH_ELEMENT;
+	}
+	// the payload of id, which must be in an allocated page.
+	P &at(int id) const {
+		return reinterpret_cast<P &>(dir[size_t(id) >> PAGE_BITS][id
+				& (PAGE_SIZE - 1)]);
+	}
+	// returns the slot of the given id, allocating its page if needed.
+	void *slot(int id) {
+		size_t page = size_t(id) >> PAGE_BITS;
+		if (page >= dirsz) {
+			size_t n = std::max(page + 1, 2 * dirsz);
+			Raw **d = static_cast<Raw **>(realloc(dir, n * sizeof(Raw *)));
+			if (d == 0)
+				throw std::bad_alloc();
+			memset(d + dirsz, 0, (n - dirsz) * sizeof(Raw *));
+			dir = d;
+			dirsz = n;
+		}
+		if (dir[page] == 0)
+			dir[page] = new Raw[PAGE_SIZE];
+		return &dir[page][id & (PAGE_SIZE - 1)];
+	}
+	// constructs the payload of a new element and inserts its key.
+	template<typename ... Args>
+	void create(int id, Args&&... args) {
+		ensure_not_existing(id);
+		P *p = new (slot(id)) P(std::forward<Args>(args)...);
+		try {
+			heap.insert_unchecked(id, key_of(*p));
+		} catch (...) {
+			p->~P();
+			throw;
+		}
+	}
+	// takes the payload of id out, which has just been removed from the heap.
+	Element take(int id) {
+		P &p = at(id);
+		Element r(id, std::move(p));
+		p.~P();
+		return r;
+	}
+	// destroys all payloads.
+	void destroy_all() {
+		heap.for_each([this](const typename Heap::Element &e) {
+			at(e.id).~P();
+		});
+	}
+public:
+	SplitPairingHeap() :
+			dir(0), dirsz(0) {
+	}
+	SplitPairingHeap(int max_size) :
+			heap(max_size), dir(0), dirsz(0) {
+	}
+	~SplitPairingHeap() {
+		destroy_all();
+		for (size_t i = 0; i < dirsz; ++i)
+			delete[] dir[i];
+		free(dir);
+	}
+	void clear() {
+		destroy_all();
+		heap.clear();
+	}
+	size_t size() const {
+		return heap.size();
+	}
+	size_t max_size() const {
+		return heap.max_size();
+	}
+	bool contains(int id) const {
+		return heap.contains(id);
+	}
+	const Stats &stats() const {
+		return heap.stats();
+	}
+	// only the node of the key is prefetched, not the payload.
+	void prefetch(int id) const {
+		heap.prefetch(id);
+	}
+	void insert(int id, const P& payload) {
+		create(id, payload);
+	}
+	void insert(int id, P&& payload) {
+		create(id, std::move(payload));
+	}
+	template<typename ... Args>
+	void emplace(int id, Args&&... args) {
+		create(id, std::forward<Args>(args)...);
+	}
+	int find_min() const {
+		return heap.find_min().id;
+	}
+	const P &get(int id) const {
+		ensure_existing(id);
+		return at(id);
+	}
+	const K &get_key(int id) const {
+		return heap.get_key(id);
+	}
+	Element delete_min() {
+		return take(heap.delete_min().id);
+	}
+	Element remove(int id) {
+		return take(heap.remove(id).id);
+	}
+	void update(int id, const P& payload) {
+		modify(id, [&payload](P &p) {
+			p = payload;
+		});
+	}
+	void update(int id, P&& payload) {
+		modify(id, [&payload](P &p) {
+			p = std::move(payload);
+		});
+	}
+	template<typename F>
+	void modify(int id, F fn) {
+		ensure_existing(id);
+		P &p = at(id);
+		fn(p);
+		heap.update_key_unchecked(id, key_of(p));
+	}
+	template<typename F>
+	void for_each(F fn) const {
+		heap.for_each([this, &fn](const typename Heap::Element &e) {
+			fn(e.id, const_cast<const P &>(at(e.id)));
+		});
+	}
+};
+
+/**
+ * The following are possible exceptions.
+ */
+template<typename P, typename KeyOf, typename Comparator,
+		template<typename > class NodeAlloc, typename Layout, typename Variant,
+		typename Stats>
+const PH_Exception SplitPairingHeap<P, KeyOf, Comparator, NodeAlloc, Layout, Variant, Stats>::PH_EX_ALREADY_EXISTS(
+		"An element with the same ID already exists.");
+template<typename P, typename KeyOf, typename Comparator,
+		template<typename > class NodeAlloc, typename Layout, typename Variant,
+		typename Stats>
+const PH_Exception SplitPairingHeap<P, KeyOf, Comparator, NodeAlloc, Layout, Variant, Stats>::PH_EX_BAD_ID("ID out of range!");
+template<typename P, typename KeyOf, typename Comparator,
+		template<typename > class NodeAlloc, typename Layout, typename Variant,
+		typename Stats>
+const PH_Exception SplitPairingHeap<P, KeyOf, Comparator, NodeAlloc, Layout, Variant, Stats>::PH_EX_NO_SUCH_ELEMENT(
+		"The heap contains no element with this ID!");
+
+#endif /* SPLITPAIRINGHEAP_H_ */
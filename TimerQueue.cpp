@@ -0,0 +1,119 @@
+//============================================================================
+// Name        : TimerQueue.cpp
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : Test program for TimerQueue.h
+//============================================================================
+
+#include "TimerQueue.h"
+#include <iostream>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <iterator>
+using namespace std;
+
+const int mn = 1000;
+
+/**
+ * random schedules, reschedules, cancels and pops against a std::multimap of deadlines to id's,
+ * while the time goes on. Deadlines are drawn from a short window so that many of them are equal,
+ * and the timers with the same deadline must expire in the order of their id's.
+ */
+template<typename Q>
+bool model(int ops) {
+	typedef multimap<long long, int> M;
+	Q q(mn);
+	M ref;
+	vector<typename M::iterator> at(mn, ref.end());
+	long long now = 0;
+	bool ok = 1;
+	for (int i = 0; i < ops && ok; ++i) {
+		int id = rand() % mn, op = rand() % 8;
+		bool has = at[id] != ref.end();
+		long long d = now + rand() % 50;
+		if (op < 2) {
+			try {
+				q.schedule(id, d);
+				ok = !has;
+				at[id] = ref.insert(make_pair(d, id));
+			} catch (PH_Exception &) {
+				ok = has;
+			}
+		} else if (op < 4) {
+			// earlier or later than the deadline it has, or a new timer.
+			if (has)
+				d = at[id]->first + (op == 2 ? -1 : 1) * (rand() % 50);
+			q.reschedule(id, d);
+			if (has)
+				ref.erase(at[id]);
+			at[id] = ref.insert(make_pair(d, id));
+		} else if (op == 4) {
+			ok = q.cancel(id) == has;
+			if (has) {
+				ref.erase(at[id]);
+				at[id] = ref.end();
+			}
+		} else if (op == 5) {
+			now += rand() % 20;
+			vector<typename Q::Timer> out;
+			q.pop_expired(now, back_inserter(out));
+			vector<pair<long long, int> > want;
+			for (typename M::iterator it = ref.begin(); it != ref.end() && it->first <= now; it = ref.begin()) {
+				want.push_back(*it);
+				at[it->second] = ref.end();
+				ref.erase(it);
+			}
+			sort(want.begin(), want.end());
+			ok = out.size() == want.size();
+			for (size_t j = 0; j < out.size() && ok; ++j)
+				ok = out[j].key == want[j].first && out[j].id == want[j].second;
+		} else if (has)
+			ok = q.scheduled(id) && q.deadline(id) == at[id]->first;
+		else
+			ok = !q.scheduled(id);
+		ok = ok && q.size() == ref.size() && q.empty() == ref.empty()
+				&& (ref.empty() || q.next_deadline() == ref.begin()->first);
+	}
+	vector<typename Q::Timer> out;
+	q.pop_expired(ref.empty() ? now : ref.rbegin()->first, back_inserter(out));
+	return ok && out.size() == ref.size() && q.empty();
+}
+
+// timers with the same deadline expire in the order of their id's, however they were scheduled.
+bool ties() {
+	TimerQueue<int> q(mn);
+	vector<int> ids;
+	for (int i = 0; i < 100; ++i)
+		ids.push_back(i * 7 % 100);
+	for (int i = 0; i < 100; ++i)
+		q.schedule(ids[i], ids[i] % 2 ? 10 : 20);
+	// half of the timers at 20 move to 10, and one at 10 is cancelled.
+	for (int i = 0; i < 100; i += 4)
+		q.reschedule(i, 10);
+	bool ok = q.cancel(3) && !q.cancel(3) && !q.cancel(500) && q.size() == 99;
+	vector<TimerQueue<int>::Timer> out;
+	q.pop_expired(9, back_inserter(out));
+	ok = ok && out.empty() && q.next_deadline() == 10;
+	q.pop_expired(10, back_inserter(out));
+	for (size_t j = 0; j < out.size() && ok; ++j)
+		ok = out[j].key == 10 && (j == 0 || out[j - 1].id < out[j].id);
+	ok = ok && out.size() == 50 + 25 - 1;
+	out.clear();
+	q.pop_expired(1000, back_inserter(out));
+	for (size_t j = 0; j < out.size() && ok; ++j)
+		ok = out[j].key == 20 && (j == 0 || out[j - 1].id < out[j].id);
+	return ok && out.size() == 25 && q.empty();
+}
+
+int main() {
+	srand(time(0));
+	cout << "ties: " << ties() << endl;
+	cout << "two pass: " << model<TimerQueue<long long> >(300000) << endl;
+	cout << "pool, auxiliary: " << model<TimerQueue<long long, PH_PoolAlloc, PH_PointerLayout, PH_AuxTwoPass> >(300000)
+			<< endl;
+	cout << "index layout: " << model<TimerQueue<long long, PH_NewAlloc, PH_IndexLayout> >(300000) << endl;
+	return 0;
+}
@@ -0,0 +1,144 @@
+//============================================================================
+// Name        : TimerQueue.h
+// Author      : ftfish (ftfish@gmail.com)
+// Version     : 0.1
+// Description : timer queues for event loops, made of a pairing heap
+//============================================================================
+
+#ifndef TIMERQUEUE_H_
+#define TIMERQUEUE_H_
+
+#include "PairingHeap.h"
+
+/**
+ * The class of timer queues: timers with an id and a deadline, which expire when the time passes it.
+ * It's meant to replace a timer wheel in an event loop: schedule, cancel and reschedule as often as needed,
+ * wait until next_deadline, then fire everything pop_expired returns.
+ *
+ * Algo:
+ * 		A @PairingHeap of the deadlines, with the id's of the timers.
+ * 		Timers with the same deadline are ordered by id (PH_IdTieBreak), so they always fire in the same order.
+ * 		Rescheduling is update_key: a later deadline only combines the children of the timer, an earlier one cuts it.
+ * 		pop_expired pops the roots until one is later than now, with a check and a consolidation of the
+ * 		auxiliary list for all of them, instead of a find_min and a delete_min per timer (see PairingHeap::extract_until).
+ *
+ * Template parameters:
+ * 		typename Time:
+ * 			the type of the deadlines, e.g. nanoseconds since some epoch as uint64_t, or a std::chrono::time_point.
+ * 			Earlier deadlines are smaller with operator <.
+ * 		NodeAlloc, Layout, Variant, Stats:
+ * 			the same as in @PairingHeap. PH_PoolAlloc saves a trip to the global heap for each schedule,
+ * 			and PH_Auxiliary<...> makes schedule and reschedule to an earlier deadline a couple of link writes.
+ *
+ * Public methods:
+ * 		TimerQueue(int max_size), TimerQueue():
+ * 			the same as in @PairingHeap.
+ * 		size, max_size, clear, stats, prefetch, memory_bytes, reserve, shrink_to_fit:
+ * 			the same as in @PairingHeap.
+ *		void schedule(int id, const Time& deadline):
+ *			starts a timer with the given id.
+ *			Throws an exception if the id is invalid or there's already a timer with that id.
+ *		void reschedule(int id, const Time& deadline):
+ *			moves the timer with the given id to the new deadline, earlier or later, and starts it if there's none.
+ *			Throws an exception if the id is invalid.
+ *		bool cancel(int id):
+ *			stops the timer with the given id. Returns false if there's none (e.g. it has fired already).
+ *		bool scheduled(int id), const Time &deadline(int id):
+ *			whether there's a timer with the given id, and its deadline.
+ *		bool empty(), const Time &next_deadline():
+ *			whether there's no timer, and the earliest deadline. next_deadline throws an exception if there's no timer.
+ *		OutIt pop_expired(const Time& now, OutIt out):
+ *			removes all timers whose deadline isn't later than now and writes them to out as Timer's,
+ *			in the order of their deadlines.
+ * Time:
+ * 		Those of @PairingHeap. Pop_expired takes O(k logn) amortized time for k expired timers.
+ */
+template<typename Time, template<typename > class NodeAlloc = PH_NewAlloc,
+		typename Layout = PH_PointerLayout, typename Variant = PH_TwoPass,
+		typename Stats = PH_NoStats>
+class TimerQueue {
+public:
+	typedef PairingHeap<Time, PH_IdTieBreak<std::less<Time> >, NodeAlloc,
+			Layout, Variant, Stats> Heap;
+	/**
+	 * A timer: its id and its deadline, as the key.
+	 */
+	typedef typename Heap::Element Timer;
+private:
+	Heap heap;
+
+	TimerQueue(const TimerQueue &) = delete;
+	TimerQueue &operator=(const TimerQueue &) = delete;
+public:
+	TimerQueue() {
+	}
+	TimerQueue(int max_size) :
+			heap(max_size) {
+	}
+	void clear() {
+		heap.clear();
+	}
+	size_t size() const {
+		return heap.size();
+	}
+	size_t max_size() const {
+		return heap.max_size();
+	}
+	bool empty() const {
+		return heap.size() == 0;
+	}
+	const Stats &stats() const {
+		return heap.stats();
+	}
+	size_t memory_bytes() const {
+		return heap.memory_bytes();
+	}
+	void reserve(size_t n) {
+		heap.reserve(n);
+	}
+	void shrink_to_fit() {
+		heap.shrink_to_fit();
+	}
+	void prefetch(int id) const {
+		heap.prefetch(id);
+	}
+	void schedule(int id, const Time& deadline) {
+		heap.insert(id, deadline);
+	}
+	void reschedule(int id, const Time& deadline) {
+		if (heap.contains(id))
+			heap.update_key_unchecked(id, deadline);
+		else
+			heap.insert(id, deadline);
+	}
+	bool cancel(int id) {
+		if (!heap.contains(id))
+			return false;
+		heap.remove_unchecked(id);
+		return true;
+	}
+	bool scheduled(int id) const {
+		return heap.contains(id);
+	}
+	const Time &deadline(int id) const {
+		return heap.get_key(id);
+	}
+	/**
+	 * returns the earliest deadline, e.g. for the timeout of poll or epoll_wait.
+	 * Throws an exception if there's no timer.
+	 */
+	const Time &next_deadline() const {
+		return heap.find_min().key;
+	}
+	/**
+	 * removes all timers whose deadline isn't later than now, and writes them to out in the order of their deadlines.
+	 * Returns the output iterator after the last timer written.
+	 * The timers are out of the queue before any of them is fired, so a callback may schedule or cancel freely.
+	 */
+	template<typename OutIt>
+	OutIt pop_expired(const Time& now, OutIt out) {
+		return heap.extract_until(now, out);
+	}
+};
+
+#endif /* TIMERQUEUE_H_ */